@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+#include "SLQ_Auxil.hpp"
+
+// reference single-producer multiple-consumer broadcast queues, providing the same interface as SeqLockQueue
+// (ContentType, enqueue, get_reader, QueueReader::read_next_entry) so they can be measured with the same harness
+namespace Baselines {
+// std::deque guarded by a std::mutex, holds at most length_ entries and drops the oldest one when full,
+// i.e. like SeqLockQueue the producer never waits for readers
+template<typename ContentType_, std::uint32_t length_>
+struct MutexDequeQueue {
+private:
+   mutable std::mutex mutex;
+   std::deque<ContentType_> entries;
+   // queue index of entries.front()
+   std::int64_t base_index = 0;
+
+   struct QueueReader {
+   private:
+      const MutexDequeQueue* const queue_ptr;
+      std::int64_t read_index = 0;
+
+   public:
+      explicit QueueReader(const MutexDequeQueue* queue_ptr_) noexcept:
+          queue_ptr(queue_ptr_) {};
+
+      std::optional<ContentType_> read_next_entry() noexcept {
+         const std::lock_guard lock(this->queue_ptr->mutex);
+         // entries that have been dropped are skipped
+         this->read_index = std::max(this->read_index, this->queue_ptr->base_index);
+         const std::int64_t offset = this->read_index - this->queue_ptr->base_index;
+         if(offset >= static_cast<std::int64_t>(this->queue_ptr->entries.size())) {
+            return std::nullopt;
+         }
+         ++this->read_index;
+         return this->queue_ptr->entries[offset];
+      };
+   };
+
+public:
+   using ContentType = ContentType_;
+   using ReaderType = QueueReader;
+
+   void enqueue(const ContentType_ content) {
+      const std::lock_guard lock(this->mutex);
+      if(this->entries.size() == length_) {
+         this->entries.pop_front();
+         ++this->base_index;
+      }
+      this->entries.push_back(content);
+   };
+
+   QueueReader get_reader() const noexcept {
+      return QueueReader(this);
+   };
+};
+
+// next of capacity reader indices, nullopt once all of them are taken
+inline std::optional<std::uint32_t> claim_reader_index(std::atomic<std::uint32_t>& n_readers, const std::size_t capacity) noexcept {
+   std::uint32_t r = n_readers.load(std::memory_order_relaxed);
+   do {
+      if(r >= capacity) {
+         return std::nullopt;
+      }
+   } while(!n_readers.compare_exchange_weak(r, r + 1, std::memory_order_acq_rel));
+   return r;
+};
+
+// broadcast by copying: one Lamport single-producer single-consumer ring per reader, the producer writes every entry into
+// each ring and waits if a reader's ring is full
+// readers have to be obtained before the producer starts enqueueing
+template<typename ContentType_, std::uint32_t length_>
+requires (std::has_single_bit(length_))
+struct LamportFanOutQueue {
+private:
+   struct alignas(SLQ_Auxil::cacheline) Ring {
+      alignas(SLQ_Auxil::cacheline) std::atomic<std::int64_t> head = 0;
+      alignas(SLQ_Auxil::cacheline) std::atomic<std::int64_t> tail = 0;
+      alignas(SLQ_Auxil::cacheline) std::array<ContentType_, length_> entries;
+   };
+   // a ring per reader the queue was constructed for, each of them holds length_ entries
+   const std::unique_ptr<Ring[]> memory_pointer;
+   const std::span<Ring> rings;
+   mutable std::atomic<std::uint32_t> n_readers = 0;
+
+   struct QueueReader {
+   private:
+      // nullptr if the queue's rings are taken already
+      Ring* const ring;
+
+   public:
+      explicit QueueReader(Ring* ring_) noexcept:
+          ring(ring_) {};
+
+      std::optional<ContentType_> read_next_entry() noexcept {
+         if(this->ring == nullptr) {
+            return std::nullopt;
+         }
+         const std::int64_t tail = this->ring->tail.load(std::memory_order_relaxed);
+         if(tail == this->ring->head.load(std::memory_order_acquire)) {
+            return std::nullopt;
+         }
+         const ContentType_ ret = this->ring->entries[tail % length_];
+         this->ring->tail.store(tail + 1, std::memory_order_release);
+         return ret;
+      };
+   };
+
+public:
+   using ContentType = ContentType_;
+   using ReaderType = QueueReader;
+
+   // rings are only allocated for max_readers readers, further readers never read anything
+   explicit LamportFanOutQueue(const std::uint32_t max_readers):
+       memory_pointer{new Ring[max_readers]},
+       rings{this->memory_pointer.get(), max_readers} {};
+
+   void enqueue(const ContentType_ content) noexcept {
+      const std::uint32_t readers = this->n_readers.load(std::memory_order_acquire);
+      for(std::uint32_t r = 0; r < readers; ++r) {
+         Ring& ring = this->rings[r];
+         const std::int64_t head = ring.head.load(std::memory_order_relaxed);
+         while(head - ring.tail.load(std::memory_order_acquire) == length_);
+         ring.entries[head % length_] = content;
+         ring.head.store(head + 1, std::memory_order_release);
+      }
+   };
+
+   QueueReader get_reader() const noexcept {
+      const std::optional<std::uint32_t> r = claim_reader_index(this->n_readers, this->rings.size());
+      return QueueReader(r.has_value() ? &this->rings[r.value()] : nullptr);
+   };
+};
+
+// disruptor-style ring: a single buffer shared by all readers, each reader publishes its own cursor and the producer
+// waits for the slowest reader before overwriting an entry it hasn't read yet
+// readers have to be obtained before the producer starts enqueueing
+template<typename ContentType_, std::uint32_t length_>
+requires (std::has_single_bit(length_))
+struct DisruptorQueue {
+private:
+   struct alignas(SLQ_Auxil::cacheline) Cursor {
+      std::atomic<std::int64_t> value = 0;
+   };
+   const std::unique_ptr<ContentType_[]> entries{new ContentType_[length_]};
+   alignas(SLQ_Auxil::cacheline) std::atomic<std::int64_t> published = 0;
+   // data used by enqueueing thread, cached minimum of all reader cursors
+   alignas(SLQ_Auxil::cacheline) std::int64_t gating_cursor = 0;
+   // a cursor per reader the queue was constructed for
+   const std::unique_ptr<Cursor[]> cursor_memory;
+   const std::span<Cursor> reader_cursors;
+   mutable std::atomic<std::uint32_t> n_readers = 0;
+
+   struct QueueReader {
+   private:
+      const DisruptorQueue* const queue_ptr;
+      // nullptr if the queue's cursors are taken already
+      Cursor* const cursor;
+      std::int64_t read_index = 0;
+      // cached value of the producer's cursor, avoids touching its cacheline for every entry
+      std::int64_t available = 0;
+
+   public:
+      explicit QueueReader(const DisruptorQueue* queue_ptr_, Cursor* cursor_) noexcept:
+          queue_ptr(queue_ptr_),
+          cursor(cursor_) {};
+
+      std::optional<ContentType_> read_next_entry() noexcept {
+         if(this->cursor == nullptr) {
+            return std::nullopt;
+         }
+         if(this->read_index == this->available) {
+            this->available = this->queue_ptr->published.load(std::memory_order_acquire);
+            if(this->read_index == this->available) {
+               return std::nullopt;
+            }
+         }
+         const ContentType_ ret = this->queue_ptr->entries[this->read_index % length_];
+         ++this->read_index;
+         this->cursor->value.store(this->read_index, std::memory_order_release);
+         return ret;
+      };
+   };
+
+public:
+   using ContentType = ContentType_;
+   using ReaderType = QueueReader;
+
+   // cursors are only allocated for max_readers readers, further readers never read anything and don't gate the
+   // producer
+   explicit DisruptorQueue(const std::uint32_t max_readers):
+       cursor_memory{new Cursor[max_readers]},
+       reader_cursors{this->cursor_memory.get(), max_readers} {};
+
+   void enqueue(const ContentType_ content) noexcept {
+      const std::int64_t sequence = this->published.load(std::memory_order_relaxed);
+      // wait until the slowest reader has read the entry about to be overwritten
+      while(sequence - this->gating_cursor >= length_) {
+         std::int64_t min_cursor = sequence;
+         const std::uint32_t readers = this->n_readers.load(std::memory_order_acquire);
+         for(std::uint32_t r = 0; r < readers; ++r) {
+            min_cursor = std::min(min_cursor, this->reader_cursors[r].value.load(std::memory_order_acquire));
+         }
+         this->gating_cursor = min_cursor;
+      }
+      this->entries[sequence % length_] = content;
+      this->published.store(sequence + 1, std::memory_order_release);
+   };
+
+   QueueReader get_reader() const noexcept {
+      const std::optional<std::uint32_t> r = claim_reader_index(this->n_readers, this->reader_cursors.size());
+      return QueueReader(this, r.has_value() ? &this->reader_cursors[r.value()] : nullptr);
+   };
+};
+} // namespace Baselines
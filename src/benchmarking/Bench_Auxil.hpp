@@ -0,0 +1,402 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Histogram.hpp"
+#include "History.hpp"
+#include "PerfCounters.hpp"
+#include "SLQ_Auxil.hpp"
+#include "Topology.hpp"
+
+namespace Bench_Auxil {
+// time stamp counter if available, steady_clock nanoseconds otherwise, the same clock SeqLockQueue time stamps entries with
+inline std::uint64_t read_tsc() noexcept {
+   return SLQ_Auxil::read_tsc();
+};
+
+// time stamp counter read that isn't reordered with surrounding instructions, for timing short sections of code
+inline std::uint64_t read_tsc_ordered() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+   _mm_lfence();
+   const std::uint64_t ret = __rdtsc();
+   _mm_lfence();
+   return ret;
+#else
+   std::atomic_signal_fence(std::memory_order_seq_cst);
+   const std::uint64_t ret = read_tsc();
+   std::atomic_signal_fence(std::memory_order_seq_cst);
+   return ret;
+#endif
+};
+
+// converts time stamp counter ticks to nanoseconds, calibrated against steady_clock on construction
+struct TscClock {
+   double ticks_per_ns = 1;
+
+   explicit TscClock(const std::chrono::milliseconds calibration_time = std::chrono::milliseconds(200)) {
+      const auto clock_begin = std::chrono::steady_clock::now();
+      const std::uint64_t tsc_begin = read_tsc();
+      while(std::chrono::steady_clock::now() - clock_begin < calibration_time);
+      const std::uint64_t tsc_end = read_tsc();
+      const auto clock_end = std::chrono::steady_clock::now();
+      this->ticks_per_ns = (tsc_end - tsc_begin) / std::chrono::duration<double, std::nano>(clock_end - clock_begin).count();
+   };
+
+   double to_ns(const std::uint64_t ticks) const noexcept { return ticks / this->ticks_per_ns; };
+   std::uint64_t to_ticks(const double ns) const noexcept { return static_cast<std::uint64_t>(ns * this->ticks_per_ns); };
+};
+
+// trivially copyable payload of a given size, the first (up to) 8 bytes carry a sequence number
+template<std::size_t size>
+requires (size >= 4)
+struct Payload {
+   static constexpr std::size_t sequence_bytes = std::min<std::size_t>(size, sizeof(std::uint64_t));
+   std::array<std::byte, size> bytes{};
+
+   void stamp(const std::uint64_t sequence) noexcept {
+      std::memcpy(bytes.data(), &sequence, sequence_bytes);
+   };
+
+   std::uint64_t sequence() const noexcept {
+      std::uint64_t ret = 0;
+      std::memcpy(&ret, bytes.data(), sequence_bytes);
+      return ret;
+   };
+
+   // payloads of at least 16 bytes carry a time stamp in bytes 8 to 15
+   void stamp_time(const std::uint64_t tsc) noexcept
+   requires (size >= 16)
+   {
+      std::memcpy(bytes.data() + sizeof(std::uint64_t), &tsc, sizeof(tsc));
+   };
+
+   std::uint64_t time() const noexcept
+   requires (size >= 16)
+   {
+      std::uint64_t ret = 0;
+      std::memcpy(&ret, bytes.data() + sizeof(std::uint64_t), sizeof(ret));
+      return ret;
+   };
+};
+
+struct ThroughputResult {
+   double producer_seconds = 0;
+   std::uint64_t messages = 0;
+   std::vector<double> reader_seconds;
+   std::vector<std::uint64_t> reader_messages;
+   // messages a reader never saw because they were overwritten before it got to them
+   std::vector<std::uint64_t> reader_overruns;
+   // hardware counters of the producer's and each reader's measured region
+   PerfCounters::CounterValues producer_counters;
+   std::vector<PerfCounters::CounterValues> reader_counters;
+};
+
+// runs one producer enqueueing n_messages back-to-back and n_readers reading concurrently until they have seen the last
+// message, QueueType must provide enqueue, get_reader and a reader providing read_next_entry
+// if cpus isn't empty the producer is pinned to cpus[0] and reader r to cpus[r + 1]
+template<typename QueueType>
+ThroughputResult run_throughput(QueueType& queue, const unsigned n_readers, const std::uint64_t n_messages,
+   const std::vector<unsigned>& cpus = {}) {
+   using PayloadType = QueueType::ContentType;
+   ThroughputResult result;
+   result.messages = n_messages;
+   result.reader_seconds.resize(n_readers);
+   result.reader_messages.resize(n_readers);
+   result.reader_overruns.resize(n_readers);
+   result.reader_counters.resize(n_readers);
+   std::atomic<unsigned> ready{0};
+   std::atomic<bool> start{false};
+   std::atomic<bool> producer_done{false};
+
+   std::vector<std::thread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&, r]() {
+         const Topology::ScopedPin pin(Topology::cpu_at(cpus, r + 1));
+         auto reader = queue.get_reader();
+         std::uint64_t expected = 0;
+         std::uint64_t n_read = 0;
+         std::uint64_t overruns = 0;
+         PerfCounters::CounterGroup counters;
+         ready.fetch_add(1);
+         while(!start.load(std::memory_order_acquire));
+         counters.start();
+         const auto begin = std::chrono::steady_clock::now();
+         while(expected < n_messages) {
+            const bool done = producer_done.load(std::memory_order_acquire);
+            const auto entry = reader.read_next_entry();
+            if(!entry.has_value()) {
+               // everything had been written before the read, an empty read means the reader has caught up
+               if(done) {
+                  break;
+               }
+               continue;
+            }
+            const std::uint64_t sequence = entry->sequence();
+            overruns += sequence > expected ? sequence - expected : 0;
+            expected = std::max(expected, sequence + 1);
+            ++n_read;
+         }
+         const auto end = std::chrono::steady_clock::now();
+         result.reader_counters[r] = counters.stop();
+         result.reader_seconds[r] = std::chrono::duration<double>(end - begin).count();
+         result.reader_messages[r] = n_read;
+         result.reader_overruns[r] = overruns;
+      });
+   }
+   while(ready.load() < n_readers);
+
+   const Topology::ScopedPin pin(Topology::cpu_at(cpus, 0));
+   PayloadType message{};
+   PerfCounters::CounterGroup counters;
+   start.store(true, std::memory_order_release);
+   counters.start();
+   const auto begin = std::chrono::steady_clock::now();
+   for(std::uint64_t i = 0; i < n_messages; ++i) {
+      message.stamp(i);
+      queue.enqueue(message);
+   }
+   const auto end = std::chrono::steady_clock::now();
+   result.producer_counters = counters.stop();
+   producer_done.store(true, std::memory_order_release);
+   result.producer_seconds = std::chrono::duration<double>(end - begin).count();
+   for(auto& t : readers) {
+      t.join();
+   }
+   return result;
+};
+
+using LatencyHistogram = Histogram::HdrHistogram<>;
+
+inline void print_percentiles_header() {
+   std::printf("%-10s %-32s %10s %9s %9s %9s %9s %9s\n", "", "configuration", "samples", "p50 ns", "p90 ns", "p99 ns", "p99.9 ns",
+      "max ns");
+};
+
+inline void print_percentiles(const char* measurement, const char* configuration, const LatencyHistogram& histogram,
+   const TscClock& clock) {
+   std::printf("%-10s %-32s %10llu %9.0f %9.0f %9.0f %9.0f %9.0f\n", measurement, configuration,
+      static_cast<unsigned long long>(histogram.count()), clock.to_ns(histogram.percentile(50)), clock.to_ns(histogram.percentile(90)),
+      clock.to_ns(histogram.percentile(99)), clock.to_ns(histogram.percentile(99.9)), clock.to_ns(histogram.max()));
+};
+
+// producer enqueues a message stamped with the time stamp counter every interval ticks, every reader records the time
+// between the stamp and successfully reading the message
+// if cpus isn't empty the producer is pinned to cpus[0] and reader r to cpus[r + 1]
+// returns an empty histogram without enqueueing anything if n_readers == 0
+template<typename QueueType>
+LatencyHistogram run_one_way_latency(QueueType& queue, const unsigned n_readers, const std::uint64_t n_messages,
+   const std::uint64_t interval, const std::vector<unsigned>& cpus = {}) {
+   LatencyHistogram result;
+   if(n_readers == 0) {
+      return result;
+   }
+   std::vector<LatencyHistogram> histograms(n_readers);
+   std::atomic<unsigned> ready{0};
+   std::atomic<bool> producer_done{false};
+
+   std::vector<std::thread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&, r]() {
+         const Topology::ScopedPin pin(Topology::cpu_at(cpus, r + 1));
+         auto reader = queue.get_reader();
+         LatencyHistogram& histogram = histograms[r];
+         ready.fetch_add(1);
+         while(true) {
+            const bool done = producer_done.load(std::memory_order_acquire);
+            const auto entry = reader.read_next_entry();
+            if(entry.has_value()) {
+               histogram.record(read_tsc() - entry->time());
+            }
+            else if(done) {
+               break;
+            }
+         }
+      });
+   }
+   while(ready.load() < n_readers);
+
+   const Topology::ScopedPin pin(Topology::cpu_at(cpus, 0));
+   typename QueueType::ContentType message{};
+   std::uint64_t next = read_tsc();
+   for(std::uint64_t i = 0; i < n_messages; ++i) {
+      while(read_tsc() < next);
+      message.stamp(i);
+      message.stamp_time(read_tsc());
+      queue.enqueue(message);
+      next += interval;
+   }
+   producer_done.store(true, std::memory_order_release);
+   for(auto& t : readers) {
+      t.join();
+   }
+   for(const LatencyHistogram& histogram : histograms) {
+      result.merge(histogram);
+   }
+   return result;
+};
+
+// enqueues a ping into ping_queue and waits for the pong another thread enqueues into pong_queue upon reading the ping
+// if cpus isn't empty the pinging thread is pinned to cpus[0] and the responding thread to cpus[1]
+template<typename QueueType>
+LatencyHistogram run_round_trip(QueueType& ping_queue, QueueType& pong_queue, const std::uint64_t n_round_trips,
+   const std::vector<unsigned>& cpus = {}) {
+   LatencyHistogram histogram;
+
+   std::thread responder([&]() {
+      const Topology::ScopedPin pin(Topology::cpu_at(cpus, 1));
+      auto reader = ping_queue.get_reader();
+      for(std::uint64_t i = 0; i < n_round_trips; ++i) {
+         std::optional<typename QueueType::ContentType> ping;
+         while(!(ping = reader.read_next_entry()).has_value());
+         pong_queue.enqueue(ping.value());
+      }
+   });
+
+   const Topology::ScopedPin pin(Topology::cpu_at(cpus, 0));
+   auto reader = pong_queue.get_reader();
+   typename QueueType::ContentType message{};
+   for(std::uint64_t i = 0; i < n_round_trips; ++i) {
+      const std::uint64_t begin = read_tsc();
+      message.stamp(i);
+      message.stamp_time(begin);
+      ping_queue.enqueue(message);
+      std::optional<typename QueueType::ContentType> pong;
+      while(!(pong = reader.read_next_entry()).has_value());
+      histogram.record(read_tsc() - pong->time());
+   }
+   responder.join();
+   return histogram;
+};
+
+// appends rows to a csv file, writes the header if the file is empty
+struct CsvWriter {
+private:
+   std::FILE* file = nullptr;
+
+public:
+   explicit CsvWriter(const std::string& path, const std::string& header) {
+      if(path.empty()) {
+         return;
+      }
+      this->file = std::fopen(path.c_str(), "a");
+      if(this->file == nullptr) {
+         std::fprintf(stderr, "could not open %s for writing\n", path.c_str());
+         return;
+      }
+      std::fseek(this->file, 0, SEEK_END);
+      if(std::ftell(this->file) == 0) {
+         std::fprintf(this->file, "%s\n", header.c_str());
+      }
+   };
+   ~CsvWriter() {
+      if(this->file != nullptr) {
+         std::fclose(this->file);
+      }
+   };
+   CsvWriter(const CsvWriter&) = delete;
+   CsvWriter& operator=(const CsvWriter&) = delete;
+   CsvWriter(CsvWriter&&) = delete;
+   CsvWriter& operator=(CsvWriter&&) = delete;
+
+   void write_row(const std::string& row) {
+      if(this->file != nullptr) {
+         std::fprintf(this->file, "%s\n", row.c_str());
+      }
+   };
+};
+
+// command line options of the form --name value
+struct Arguments {
+private:
+   std::vector<std::string_view> args;
+
+public:
+   explicit Arguments(int argc, char** argv):
+       args(argv + 1, argv + argc) {};
+
+   std::string get(std::string_view name, const std::string& default_value) const {
+      for(std::size_t i = 0; i + 1 < this->args.size(); ++i) {
+         if(this->args[i].substr(0, 2) == "--" && this->args[i].substr(2) == name) {
+            return std::string(this->args[i + 1]);
+         }
+      }
+      return default_value;
+   };
+
+   std::uint64_t get(std::string_view name, const std::uint64_t default_value) const {
+      const std::string value = this->get(name, std::string{});
+      return value.empty() ? default_value : std::stoull(value);
+   };
+
+   // true if filter_name hasn't been given or its value equals value
+   bool selected(std::string_view filter_name, const std::uint64_t value) const {
+      const std::string filter = this->get(filter_name, std::string{});
+      return filter.empty() || std::stoull(filter) == value;
+   };
+};
+
+// handles the history options shared by benchmarks: --json <file> writes the results, --baseline <file> (default
+// history/<benchmark>_<host>.json) is compared against and created if it doesn't exist, --save-baseline 1 replaces it,
+// --threshold-pct (default 5) is the change considered noise. returns the process exit code, non-zero on regressions
+inline int process_history(const Arguments& args, const History::Results& results) {
+   const unsigned regressions = History::process(results, args.get("json", std::string{}),
+      args.get("baseline", History::default_baseline_path(results.benchmark)), args.get("save-baseline", std::uint64_t{0}) != 0,
+      args.get("threshold-pct", std::uint64_t{5}) / 100.0);
+   return regressions == 0 ? 0 : 2;
+};
+
+// counters per message as csv fields, unavailable counters are left empty
+inline std::string counters_csv(const PerfCounters::CounterValues& counters, const double n_messages) {
+   std::string ret;
+   for(std::size_t i = 0; i < PerfCounters::n_counters; ++i) {
+      const double value = counters.per(static_cast<PerfCounters::Counter>(i), n_messages);
+      ret += (i ? "," : "") + (value < 0 ? std::string{} : std::to_string(value));
+   }
+   return ret;
+};
+
+inline std::string counters_csv_header(const std::string& prefix) {
+   std::string ret;
+   for(std::size_t i = 0; i < PerfCounters::n_counters; ++i) {
+      ret += (i ? "," : "") + prefix + PerfCounters::counter_names[i] + "_per_msg";
+   }
+   return ret;
+};
+
+// prints counters per message on a single line, unavailable counters as n/a
+inline void print_counters(const char* label, const PerfCounters::CounterValues& counters, const double n_messages) {
+   std::printf("%24s", label);
+   for(std::size_t i = 0; i < PerfCounters::n_counters; ++i) {
+      const double value = counters.per(static_cast<PerfCounters::Counter>(i), n_messages);
+      if(value < 0) {
+         std::printf("  %s n/a", PerfCounters::counter_names[i]);
+      }
+      else {
+         std::printf("  %s %.3f", PerfCounters::counter_names[i], value);
+      }
+   }
+   std::printf("\n");
+};
+
+// number of readers used if not specified otherwise: all hardware threads but the producer's
+inline unsigned default_max_readers() {
+   return std::max(2u, std::thread::hardware_concurrency()) - 1;
+};
+} // namespace Bench_Auxil
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "Baselines.hpp"
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// measures SeqLockQueue and the reference queues in Baselines.hpp with the same harness: throughput for 1 to n readers
+// and one-way latency of paced messages
+// usage: Benchmark_Baselines [--messages n] [--max-readers n] [--latency-messages n] [--interval-ns n] [--payload bytes]
+// note that, unlike SeqLockQueue and MutexDequeQueue, the Lamport and disruptor queues make the producer wait for slow
+// readers instead of overwriting entries
+
+using Bench_Auxil::Arguments;
+
+static constexpr std::uint32_t queue_length = 1 << 16;
+
+// the Lamport and disruptor queues allocate rings and cursors for the number of readers they are constructed for
+template<typename QueueType>
+std::unique_ptr<QueueType> make_queue(const unsigned n_readers) {
+   if constexpr(std::is_constructible_v<QueueType, std::uint32_t>) {
+      return std::make_unique<QueueType>(n_readers);
+   }
+   else {
+      return std::make_unique<QueueType>();
+   }
+};
+
+template<typename QueueType>
+void run_throughput(const char* name, const Arguments& args) {
+   static constexpr std::size_t payload_size = sizeof(typename QueueType::ContentType);
+   const std::uint64_t n_messages = args.get("messages", std::uint64_t{1} << 22);
+   const unsigned max_readers = args.get("max-readers", std::uint64_t{Bench_Auxil::default_max_readers()});
+   for(unsigned n_readers = 1; n_readers <= max_readers; ++n_readers) {
+      auto queue = make_queue<QueueType>(n_readers);
+      const auto result = Bench_Auxil::run_throughput(*queue, n_readers, n_messages);
+      double reader_rate_min = n_messages / result.producer_seconds;
+      std::uint64_t overruns = 0;
+      for(unsigned r = 0; r < n_readers; ++r) {
+         reader_rate_min = std::min(reader_rate_min, result.reader_messages[r] / result.reader_seconds[r]);
+         overruns += result.reader_overruns[r];
+      }
+      std::printf("%-20s %8zu %8u %16.2f %16.2f %10.4f\n", name, payload_size, n_readers, n_messages / result.producer_seconds / 1e6,
+         reader_rate_min / 1e6, static_cast<double>(overruns) / (static_cast<double>(n_messages) * n_readers));
+   }
+};
+
+template<typename QueueType>
+void run_latency(const char* name, const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   static constexpr std::size_t payload_size = sizeof(typename QueueType::ContentType);
+   auto queue = make_queue<QueueType>(1);
+   const auto latency = Bench_Auxil::run_one_way_latency(*queue, 1, args.get("latency-messages", std::uint64_t{1} << 18),
+      clock.to_ticks(args.get("interval-ns", std::uint64_t{1000})));
+   const std::string configuration = std::string(name) + ", " + std::to_string(payload_size) + " B";
+   Bench_Auxil::print_percentiles("one-way", configuration.c_str(), latency, clock);
+};
+
+template<std::size_t payload_size>
+void run_payload(const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   if(!args.selected("payload", payload_size)) {
+      return;
+   }
+   using PayloadType = Bench_Auxil::Payload<payload_size>;
+   using SeqLockQueueType = Queue::SeqLockQueue<PayloadType, queue_length, true, false>;
+   using MutexDequeQueueType = Baselines::MutexDequeQueue<PayloadType, queue_length>;
+   using LamportFanOutQueueType = Baselines::LamportFanOutQueue<PayloadType, queue_length>;
+   using DisruptorQueueType = Baselines::DisruptorQueue<PayloadType, queue_length>;
+   std::printf("%-20s %8s %8s %16s %16s %10s\n", "queue", "payload", "readers", "prod Mmsg/s", "min reader Mmsg/s", "overruns");
+   run_throughput<SeqLockQueueType>("SeqLockQueue", args);
+   run_throughput<MutexDequeQueueType>("MutexDequeQueue", args);
+   run_throughput<LamportFanOutQueueType>("LamportFanOutQueue", args);
+   run_throughput<DisruptorQueueType>("DisruptorQueue", args);
+   Bench_Auxil::print_percentiles_header();
+   run_latency<SeqLockQueueType>("SeqLockQueue", args, clock);
+   run_latency<MutexDequeQueueType>("MutexDequeQueue", args, clock);
+   run_latency<LamportFanOutQueueType>("LamportFanOutQueue", args, clock);
+   run_latency<DisruptorQueueType>("DisruptorQueue", args, clock);
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   run_payload<16>(args, clock);
+   run_payload<64>(args, clock);
+   run_payload<256>(args, clock);
+}
@@ -0,0 +1,63 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <thread>
+#include <utility>
+
+#include "Queue.hpp"
+
+// throughput of a reader catching up on a completely filled queue much larger than the last level cache,
+// comparing batched reads with different prefetch distances
+
+struct Message {
+   std::array<std::uint64_t, 7> words;
+};
+
+// 2^22 elements of 64 bytes, i.e. 256 MB
+static constexpr std::uint32_t queue_length = 1 << 22;
+static constexpr std::uint32_t batch_size = 64;
+using QueueType = Queue::SeqLockQueue<Message, queue_length, true, true>;
+
+template<std::uint32_t prefetch_distance>
+void drain(QueueType& queue) {
+   auto reader = queue.get_reader();
+   // fill queue from another thread, so the reader's core doesn't hold any of its cachelines
+   std::thread producer([&]() {
+      Message message{};
+      for(std::uint64_t i = 0; i < queue_length; ++i) {
+         message.words[0] = i;
+         queue.enqueue(message);
+      }
+   });
+   producer.join();
+
+   std::array<Message, batch_size> batch;
+   std::uint64_t n_read = 0;
+   std::uint64_t checksum = 0;
+   const auto start = std::chrono::steady_clock::now();
+   while(n_read < queue_length) {
+      const std::uint32_t n_batch = reader.read_next_entries<prefetch_distance>(std::span<Message>{batch});
+      for(std::uint32_t i = 0; i < n_batch; ++i) {
+         checksum += batch[i].words[0];
+      }
+      n_read += n_batch;
+   }
+   const auto end = std::chrono::steady_clock::now();
+   const double seconds = std::chrono::duration<double>(end - start).count();
+   std::printf("%8u %14.2f %10.2f %12s\n", prefetch_distance, n_read / seconds / 1e6, n_read * sizeof(Message) / seconds / 1e9,
+      checksum == std::uint64_t{queue_length} * (queue_length - 1) / 2 ? "ok" : "MISMATCH");
+};
+
+template<std::uint32_t... distances>
+void sweep(std::integer_sequence<std::uint32_t, distances...>) {
+   auto queue = std::make_unique<QueueType>();
+   std::printf("%8s %14s %10s %12s\n", "distance", "Mmessages/s", "GB/s", "checksum");
+   (drain<distances>(*queue), ...);
+};
+
+int main() {
+   sweep(std::integer_sequence<std::uint32_t, 0, 1, 2, 4, 8, 16, 32, 64>{});
+}
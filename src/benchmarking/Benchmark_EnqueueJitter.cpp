@@ -0,0 +1,103 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// latency distribution of individual SeqLockQueue::enqueue calls while 0 to n readers keep polling the queue,
+// for each layout mode
+// usage: Benchmark_EnqueueJitter [--messages n] [--max-readers n] [--interval-ns n] [--payload bytes]
+// every call is timed with serialized time stamp counter reads, the timing overhead (an empty timed section) is printed
+// first and is included in all reported values
+
+using Bench_Auxil::Arguments;
+
+static constexpr std::uint32_t queue_length = 1 << 12;
+
+template<typename QueueType>
+Bench_Auxil::LatencyHistogram time_enqueue(const unsigned n_readers, const std::uint64_t n_messages, const std::uint64_t interval) {
+   auto queue = std::make_unique<QueueType>();
+   Bench_Auxil::LatencyHistogram histogram;
+   std::atomic<unsigned> ready{0};
+   std::atomic<bool> stop{false};
+   std::vector<std::thread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&]() {
+         auto reader = queue->get_reader();
+         std::uint64_t sink = 0;
+         ready.fetch_add(1);
+         while(!stop.load(std::memory_order_relaxed)) {
+            const auto entry = reader.read_next_entry();
+            sink += entry.has_value() ? entry->sequence() : 0;
+         }
+         // keep the reads from being optimized away
+         if(sink == 1) {
+            std::puts("");
+         }
+      });
+   }
+   while(ready.load() < n_readers);
+
+   typename QueueType::ContentType message{};
+   std::uint64_t next = Bench_Auxil::read_tsc();
+   for(std::uint64_t i = 0; i < n_messages; ++i) {
+      while(Bench_Auxil::read_tsc() < next);
+      message.stamp(i);
+      const std::uint64_t begin = Bench_Auxil::read_tsc_ordered();
+      queue->enqueue(message);
+      const std::uint64_t end = Bench_Auxil::read_tsc_ordered();
+      histogram.record(end - begin);
+      next += interval;
+   }
+   stop.store(true);
+   for(auto& t : readers) {
+      t.join();
+   }
+   return histogram;
+};
+
+template<std::size_t payload_size, bool share_cacheline, bool accept_UB, bool double_buffer>
+void run_layout(const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   if(!args.selected("payload", payload_size)) {
+      return;
+   }
+   using QueueType = Queue::SeqLockQueue<Bench_Auxil::Payload<payload_size>, queue_length, share_cacheline, accept_UB, double_buffer>;
+   const std::uint64_t n_messages = args.get("messages", std::uint64_t{1} << 20);
+   const std::uint64_t interval = clock.to_ticks(args.get("interval-ns", std::uint64_t{0}));
+   const unsigned max_readers = args.get("max-readers", std::uint64_t{Bench_Auxil::default_max_readers()});
+   for(unsigned n_readers = 0; n_readers <= max_readers; ++n_readers) {
+      const std::string configuration = std::to_string(payload_size) + " B" + (share_cacheline ? ", shared line" : "")
+         + (accept_UB ? ", UB" : "") + (double_buffer ? ", double buffer" : "") + ", " + std::to_string(n_readers) + " readers";
+      Bench_Auxil::print_percentiles("enqueue", configuration.c_str(), time_enqueue<QueueType>(n_readers, n_messages, interval), clock);
+   }
+};
+
+template<std::size_t payload_size>
+void run_layouts(const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   run_layout<payload_size, true, true, false>(args, clock);
+   run_layout<payload_size, true, false, false>(args, clock);
+   run_layout<payload_size, false, true, false>(args, clock);
+   run_layout<payload_size, false, false, false>(args, clock);
+   run_layout<payload_size, false, true, true>(args, clock);
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   std::printf("time stamp counter: %.3f ticks per ns\n", clock.ticks_per_ns);
+   Bench_Auxil::LatencyHistogram overhead;
+   for(int i = 0; i < 100000; ++i) {
+      const std::uint64_t begin = Bench_Auxil::read_tsc_ordered();
+      const std::uint64_t end = Bench_Auxil::read_tsc_ordered();
+      overhead.record(end - begin);
+   }
+   Bench_Auxil::print_percentiles_header();
+   Bench_Auxil::print_percentiles("overhead", "empty timed section", overhead, clock);
+   run_layouts<16>(args, clock);
+   run_layouts<64>(args, clock);
+}
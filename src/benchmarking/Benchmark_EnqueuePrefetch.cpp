@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Queue.hpp"
+
+// sweeps SeqLockQueue's prefetch_distance against the number of readers polling near the head of the queue
+// reports the producer's average cost per enqueue, readers only poll and are not measured
+
+static constexpr std::uint32_t queue_length = 1 << 16;
+static constexpr std::uint64_t n_messages = 1 << 24;
+// every reader is a thread of its own, larger arguments are rejected
+static constexpr unsigned long reader_limit = 1024;
+
+template<std::uint32_t prefetch_distance, bool share_cacheline>
+double ns_per_enqueue(unsigned n_readers) {
+   using QueueType = Queue::SeqLockQueue<std::uint64_t, queue_length, share_cacheline, true, false, prefetch_distance>;
+   auto queue = std::make_unique<QueueType>();
+   std::atomic<bool> stop{false};
+   std::atomic<unsigned> readers_ready{0};
+   std::vector<std::thread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&]() {
+         auto reader = queue->get_reader();
+         std::uint64_t sink = 0;
+         readers_ready.fetch_add(1);
+         while(!stop.load(std::memory_order_relaxed)) {
+            const auto entry = reader.read_next_entry();
+            sink += entry.value_or(0);
+         }
+         // keep the reads from being optimized away
+         if(sink == 42) {
+            std::puts("");
+         }
+      });
+   }
+   while(readers_ready.load() < n_readers);
+
+   const auto start = std::chrono::steady_clock::now();
+   for(std::uint64_t i = 0; i < n_messages; ++i) {
+      queue->enqueue(i);
+   }
+   const auto end = std::chrono::steady_clock::now();
+   stop.store(true);
+   for(auto& t : readers) {
+      t.join();
+   }
+   return std::chrono::duration<double, std::nano>(end - start).count() / n_messages;
+};
+
+template<bool share_cacheline, std::uint32_t... distances>
+void sweep(unsigned max_readers, std::integer_sequence<std::uint32_t, distances...>) {
+   std::printf("share_cacheline = %s\n%8s", share_cacheline ? "true" : "false", "readers");
+   (std::printf(" %10s%-3u", "distance ", distances), ...);
+   std::printf("\n");
+   for(unsigned n_readers = 0; n_readers <= max_readers; ++n_readers) {
+      std::printf("%8u", n_readers);
+      (std::printf(" %10.2f ns", ns_per_enqueue<distances, share_cacheline>(n_readers)), ...);
+      std::printf("\n");
+   }
+};
+
+int main(int argc, char** argv) {
+   // number of readers defaults to all but one hardware thread, can be overridden by the first argument
+   const unsigned hardware_threads = std::max(2u, std::thread::hardware_concurrency());
+   unsigned max_readers = hardware_threads - 1;
+   if(argc > 1) {
+      char* end = nullptr;
+      const unsigned long parsed = std::strtoul(argv[1], &end, 10);
+      if(end == argv[1] || *end != '\0' || argv[1][0] == '-' || parsed > reader_limit) {
+         std::printf("invalid number of readers %s, expected 0 to %lu\n", argv[1], reader_limit);
+         return 1;
+      }
+      max_readers = static_cast<unsigned>(parsed);
+   }
+   using Distances = std::integer_sequence<std::uint32_t, 0, 1, 2, 4, 8, 16, 32>;
+   sweep<true>(max_readers, Distances{});
+   sweep<false>(max_readers, Distances{});
+}
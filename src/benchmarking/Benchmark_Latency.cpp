@@ -0,0 +1,67 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// one-way producer -> reader latency and round trip latency over two queues, reported as percentiles
+// usage: Benchmark_Latency [--messages n] [--interval-ns n] [--readers n] [--round-trips n] [--payload bytes]
+//                          [--json file] [--baseline file] [--save-baseline 0|1] [--threshold-pct n]
+// one-way: the producer enqueues a message every interval-ns nanoseconds, stamped with the time stamp counter,
+//          every reader records the time between the stamp and successfully reading the message
+// round trip: one thread enqueues a ping into the first queue and waits for the pong that a second thread enqueues into
+//             the second queue upon reading the ping
+// p50 and p99 of both are compared to the host's baseline (see History.hpp)
+
+using Bench_Auxil::Arguments;
+
+static constexpr std::uint32_t queue_length = 1 << 12;
+
+template<std::size_t payload_size, bool share_cacheline, bool accept_UB, bool double_buffer>
+void run_configuration(const Arguments& args, const Bench_Auxil::TscClock& clock, History::Results& history) {
+   if(!args.selected("payload", payload_size)) {
+      return;
+   }
+   using QueueType = Queue::SeqLockQueue<Bench_Auxil::Payload<payload_size>, queue_length, share_cacheline, accept_UB, double_buffer>;
+   const std::string configuration = std::to_string(payload_size) + " B" + (share_cacheline ? ", shared line" : "")
+      + (accept_UB ? ", UB" : "") + (double_buffer ? ", double buffer" : "");
+   auto queue = std::make_unique<QueueType>();
+   const auto one_way = Bench_Auxil::run_one_way_latency(*queue, args.get("readers", std::uint64_t{1}),
+      args.get("messages", std::uint64_t{1} << 20), clock.to_ticks(args.get("interval-ns", std::uint64_t{1000})));
+   Bench_Auxil::print_percentiles("one-way", configuration.c_str(), one_way, clock);
+   history.add("one-way/" + configuration + "/p50_ns", clock.to_ns(one_way.percentile(50)), false);
+   history.add("one-way/" + configuration + "/p99_ns", clock.to_ns(one_way.percentile(99)), false);
+   auto ping_queue = std::make_unique<QueueType>();
+   auto pong_queue = std::make_unique<QueueType>();
+   const auto round_trip = Bench_Auxil::run_round_trip(*ping_queue, *pong_queue, args.get("round-trips", std::uint64_t{1} << 18));
+   Bench_Auxil::print_percentiles("round trip", configuration.c_str(), round_trip, clock);
+   history.add("round trip/" + configuration + "/p50_ns", clock.to_ns(round_trip.percentile(50)), false);
+   history.add("round trip/" + configuration + "/p99_ns", clock.to_ns(round_trip.percentile(99)), false);
+};
+
+template<std::size_t payload_size>
+void run_layouts(const Arguments& args, const Bench_Auxil::TscClock& clock, History::Results& history) {
+   run_configuration<payload_size, true, true, false>(args, clock, history);
+   run_configuration<payload_size, true, false, false>(args, clock, history);
+   run_configuration<payload_size, false, true, false>(args, clock, history);
+   run_configuration<payload_size, false, false, false>(args, clock, history);
+   run_configuration<payload_size, false, true, true>(args, clock, history);
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   std::printf("time stamp counter: %.3f ticks per ns\n", clock.ticks_per_ns);
+   Bench_Auxil::print_percentiles_header();
+   History::Results history;
+   history.benchmark = "Benchmark_Latency";
+   run_layouts<16>(args, clock, history);
+   run_layouts<64>(args, clock, history);
+   run_layouts<256>(args, clock, history);
+   return Bench_Auxil::process_history(args, history);
+}
@@ -0,0 +1,131 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// prints the layout of candidate SeqLockQueue configurations for a payload type, measures reader throughput and one-way
+// latency of each for a target number of readers and recommends the configuration with the highest reader throughput or,
+// with --optimize latency, the lowest median one-way latency
+// usage: Benchmark_LayoutAdvisor [--readers n] [--payload bytes] [--capacity n] [--messages n] [--latency-messages n]
+//                                [--interval-ns n] [--optimize throughput|latency]
+// to get advice for an actual message type, instantiate advise<MessageType> in main
+
+using Bench_Auxil::Arguments;
+
+struct Candidate {
+   std::string configuration;
+   double reader_msgs_per_s = 0;
+   double overrun_fraction = 0;
+   // only measured for payloads large enough to carry a time stamp
+   std::optional<double> one_way_p50_ns;
+};
+
+// readers missing messages aren't keeping up, configurations without overruns are preferred. among those the objective
+// decides and the other measurement breaks ties, latency is only compared if both candidates have it
+inline bool better(const Candidate& candidate, const Candidate& best, const bool optimize_latency) {
+   if((candidate.overrun_fraction == 0) != (best.overrun_fraction == 0)) {
+      return candidate.overrun_fraction == 0;
+   }
+   const bool compare_latency = candidate.one_way_p50_ns.has_value() && best.one_way_p50_ns.has_value();
+   if(optimize_latency && compare_latency && candidate.one_way_p50_ns != best.one_way_p50_ns) {
+      return candidate.one_way_p50_ns < best.one_way_p50_ns;
+   }
+   if(candidate.reader_msgs_per_s != best.reader_msgs_per_s) {
+      return candidate.reader_msgs_per_s > best.reader_msgs_per_s;
+   }
+   return compare_latency && candidate.one_way_p50_ns < best.one_way_p50_ns;
+};
+
+template<typename QueueType>
+void measure(const Arguments& args, const Bench_Auxil::TscClock& clock, const std::string& configuration,
+   std::vector<Candidate>& candidates) {
+   const std::size_t capacity = QueueType::footprint / QueueType::element_size;
+   if(!args.selected("capacity", capacity)) {
+      return;
+   }
+   const unsigned n_readers = args.get("readers", std::uint64_t{1});
+   const std::uint64_t n_messages = args.get("messages", std::uint64_t{1} << 22);
+   Candidate candidate;
+   candidate.configuration = configuration + ", " + std::to_string(capacity);
+   auto queue = std::make_unique<QueueType>();
+   const auto throughput = Bench_Auxil::run_throughput(*queue, n_readers, n_messages);
+   for(unsigned r = 0; r < n_readers; ++r) {
+      candidate.reader_msgs_per_s += throughput.reader_messages[r] / throughput.reader_seconds[r] / n_readers;
+      candidate.overrun_fraction += static_cast<double>(throughput.reader_overruns[r]) / n_messages / n_readers;
+   }
+   if constexpr(sizeof(typename QueueType::ContentType) >= 16) {
+      auto latency_queue = std::make_unique<QueueType>();
+      const auto one_way = Bench_Auxil::run_one_way_latency(*latency_queue, n_readers, args.get("latency-messages", std::uint64_t{1} << 16),
+         clock.to_ticks(args.get("interval-ns", std::uint64_t{1000})));
+      candidate.one_way_p50_ns = clock.to_ns(one_way.percentile(50));
+   }
+   const std::string p50 = candidate.one_way_p50_ns.has_value() ? std::to_string(std::llround(candidate.one_way_p50_ns.value())) : "-";
+   std::printf("%-34s %8zu %6zu %6zu %6zu %8s %7.0f%% %12zu %14.3e %9.4f %9s\n", candidate.configuration.c_str(), QueueType::element_size,
+      QueueType::alignment, QueueType::elements_per_cacheline, QueueType::cachelines_per_element, QueueType::elements_straddle_cachelines ? "yes" : "no",
+      100 * QueueType::padding_fraction, QueueType::footprint, candidate.reader_msgs_per_s, candidate.overrun_fraction, p50.c_str());
+   candidates.push_back(candidate);
+};
+
+template<typename PayloadType, std::uint32_t capacity>
+void measure_layouts(const Arguments& args, const Bench_Auxil::TscClock& clock, std::vector<Candidate>& candidates) {
+   measure<Queue::SeqLockQueue<PayloadType, capacity, true, true>>(args, clock, "shared line, UB", candidates);
+   measure<Queue::SeqLockQueue<PayloadType, capacity, true, false>>(args, clock, "shared line", candidates);
+   measure<Queue::SeqLockQueue<PayloadType, capacity, false, true>>(args, clock, "UB", candidates);
+   measure<Queue::SeqLockQueue<PayloadType, capacity, false, false>>(args, clock, "default", candidates);
+   measure<Queue::SeqLockQueue<PayloadType, capacity, false, true, true>>(args, clock, "UB, double buffer", candidates);
+};
+
+// benchmarks all candidate configurations for PayloadType and prints a recommendation
+template<typename PayloadType>
+void advise(const Arguments& args, const Bench_Auxil::TscClock& clock, const char* payload_name) {
+   std::printf("\n%s (%zu bytes), %llu reader(s)\n", payload_name, sizeof(PayloadType),
+      static_cast<unsigned long long>(args.get("readers", std::uint64_t{1})));
+   std::printf("%-34s %8s %6s %6s %6s %8s %8s %12s %14s %9s %9s\n", "configuration, capacity", "size", "align", "/line", "lines", "straddle",
+      "padding", "footprint", "reader msgs/s", "overruns", "p50 ns");
+   std::vector<Candidate> candidates;
+   measure_layouts<PayloadType, 1 << 10>(args, clock, candidates);
+   measure_layouts<PayloadType, 1 << 14>(args, clock, candidates);
+   measure_layouts<PayloadType, 1 << 18>(args, clock, candidates);
+   const bool optimize_latency = args.get("optimize", std::string{"throughput"}) == "latency";
+   std::optional<Candidate> best;
+   for(const Candidate& candidate : candidates) {
+      if(!best.has_value() || better(candidate, best.value(), optimize_latency)) {
+         best = candidate;
+      }
+   }
+   if(best.has_value()) {
+      std::printf("recommendation for %s: %s (%.3e msgs/s per reader, %.4f of messages overrun", optimize_latency ? "latency" : "throughput",
+         best->configuration.c_str(), best->reader_msgs_per_s, best->overrun_fraction);
+      if(best->one_way_p50_ns.has_value()) {
+         std::printf(", p50 %.0f ns", best->one_way_p50_ns.value());
+      }
+      std::printf(")\n");
+   }
+};
+
+template<std::size_t payload_size>
+void advise_payload(const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   if(args.selected("payload", payload_size)) {
+      advise<Bench_Auxil::Payload<payload_size>>(args, clock, ("Payload<" + std::to_string(payload_size) + ">").c_str());
+   }
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const std::string objective = args.get("optimize", std::string{"throughput"});
+   if(objective != "throughput" && objective != "latency") {
+      std::printf("unknown objective %s, expected throughput or latency\n", objective.c_str());
+      return 1;
+   }
+   const Bench_Auxil::TscClock clock;
+   advise_payload<8>(args, clock);
+   advise_payload<24>(args, clock);
+   advise_payload<64>(args, clock);
+   advise_payload<200>(args, clock);
+}
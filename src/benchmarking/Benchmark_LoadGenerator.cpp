@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// drives SeqLockQueue with realistic arrival patterns instead of back-to-back enqueues and reports reader lag, overruns
+// and latency, separately for bursts, to size the queue's capacity from data
+// usage: Benchmark_LoadGenerator [--mode constant|poisson|profile] [--rate msgs/s] [--duration-ms n] [--profile file]
+//                                [--readers n] [--reader-work-ns n] [--capacity n] [--seed n]
+// constant: messages arrive every 1 / rate seconds
+// poisson: exponentially distributed inter-arrival times with mean 1 / rate
+// profile: a recorded burst profile, one segment per line: <duration in ms> <rate in msgs/s>, lines starting with # are
+//          ignored, within a segment arrivals are poisson distributed. without --profile a built-in market open profile
+//          is used. messages in segments with at least twice the profile's average rate count as burst messages
+// reader-work-ns simulates processing every message by spinning for the given time after reading it
+
+using Bench_Auxil::Arguments;
+
+using PayloadType = Bench_Auxil::Payload<64>;
+
+struct Segment {
+   double duration_ms = 0;
+   double rate = 0;
+};
+
+// quiet pre-open, opening auction burst, elevated continuous trading, back to normal
+static const std::vector<Segment> market_open_profile = {{200, 1e5}, {50, 2e6}, {200, 5e5}, {550, 1e5}};
+
+// arrival time of every message in ticks relative to the start and whether it belongs to a burst
+struct Schedule {
+   std::vector<std::uint64_t> arrivals;
+   std::vector<bool> burst;
+};
+
+std::vector<Segment> read_profile(const std::string& path) {
+   std::vector<Segment> ret;
+   std::ifstream file(path);
+   std::string line;
+   while(std::getline(file, line)) {
+      if(line.empty() || line[0] == '#') {
+         continue;
+      }
+      std::replace(line.begin(), line.end(), ',', ' ');
+      std::istringstream fields(line);
+      Segment segment;
+      if(fields >> segment.duration_ms >> segment.rate) {
+         ret.push_back(segment);
+      }
+   }
+   return ret;
+};
+
+Schedule make_schedule(const std::vector<Segment>& segments, const bool poisson, const Bench_Auxil::TscClock& clock,
+   const std::uint64_t seed) {
+   Schedule ret;
+   double total_ms = 0;
+   double total_messages = 0;
+   for(const Segment& segment : segments) {
+      total_ms += segment.duration_ms;
+      total_messages += segment.duration_ms / 1e3 * segment.rate;
+   }
+   const double average_rate = total_messages / (total_ms / 1e3);
+   std::mt19937_64 rng(seed);
+   double now_ns = 0;
+   double segment_end_ns = 0;
+   for(const Segment& segment : segments) {
+      segment_end_ns += segment.duration_ms * 1e6;
+      if(segment.rate <= 0) {
+         now_ns = segment_end_ns;
+         continue;
+      }
+      const double mean_interval_ns = 1e9 / segment.rate;
+      std::exponential_distribution<double> interval(1 / mean_interval_ns);
+      const bool burst = segment.rate >= 2 * average_rate;
+      while(true) {
+         now_ns += poisson ? interval(rng) : mean_interval_ns;
+         if(now_ns >= segment_end_ns) {
+            now_ns = segment_end_ns;
+            break;
+         }
+         ret.arrivals.push_back(clock.to_ticks(now_ns));
+         ret.burst.push_back(burst);
+      }
+   }
+   return ret;
+};
+
+// latency in ticks and lag in messages, for burst and other messages
+struct ReaderStats {
+   Bench_Auxil::LatencyHistogram latency[2];
+   Bench_Auxil::LatencyHistogram lag[2];
+   std::uint64_t overruns[2] = {0, 0};
+};
+
+template<std::uint32_t capacity>
+void run_capacity(const Arguments& args, const Schedule& schedule, const Bench_Auxil::TscClock& clock) {
+   if(!args.selected("capacity", capacity)) {
+      return;
+   }
+   using QueueType = Queue::SeqLockQueue<PayloadType, capacity, false, false>;
+   auto queue = std::make_unique<QueueType>();
+   const unsigned n_readers = args.get("readers", std::uint64_t{1});
+   const std::uint64_t work_ticks = clock.to_ticks(args.get("reader-work-ns", std::uint64_t{0}));
+   const std::uint64_t n_messages = schedule.arrivals.size();
+   std::vector<ReaderStats> stats(n_readers);
+   // number of messages enqueued so far, lets readers compute their lag
+   std::atomic<std::uint64_t> enqueued{0};
+   std::atomic<unsigned> ready{0};
+   std::atomic<bool> producer_done{false};
+
+   std::vector<std::thread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&, r]() {
+         auto reader = queue->get_reader();
+         ReaderStats& reader_stats = stats[r];
+         std::uint64_t expected = 0;
+         ready.fetch_add(1);
+         while(true) {
+            const bool done = producer_done.load(std::memory_order_acquire);
+            const auto entry = reader.read_next_entry();
+            if(!entry.has_value()) {
+               if(done) {
+                  break;
+               }
+               continue;
+            }
+            const std::uint64_t now = Bench_Auxil::read_tsc();
+            const std::uint64_t sequence = entry->sequence();
+            const bool burst = schedule.burst[sequence];
+            reader_stats.latency[burst].record(now - entry->time());
+            // the counter is updated after enqueueing, i.e. may not include the message just read yet
+            reader_stats.lag[burst].record(std::max(enqueued.load(std::memory_order_relaxed), sequence + 1) - sequence - 1);
+            reader_stats.overruns[burst] += sequence > expected ? sequence - expected : 0;
+            expected = std::max(expected, sequence + 1);
+            const std::uint64_t work_end = now + work_ticks;
+            while(work_ticks != 0 && Bench_Auxil::read_tsc() < work_end);
+         }
+      });
+   }
+   while(ready.load() < n_readers);
+
+   PayloadType message{};
+   const std::uint64_t begin = Bench_Auxil::read_tsc();
+   for(std::uint64_t i = 0; i < n_messages; ++i) {
+      const std::uint64_t arrival = begin + schedule.arrivals[i];
+      while(Bench_Auxil::read_tsc() < arrival);
+      message.stamp(i);
+      // latency is measured from the scheduled arrival, i.e. includes any delay of the producer
+      message.stamp_time(arrival);
+      queue->enqueue(message);
+      enqueued.store(i + 1, std::memory_order_relaxed);
+   }
+   producer_done.store(true, std::memory_order_release);
+   for(auto& t : readers) {
+      t.join();
+   }
+
+   for(unsigned r = 1; r < n_readers; ++r) {
+      for(int burst = 0; burst < 2; ++burst) {
+         stats[0].latency[burst].merge(stats[r].latency[burst]);
+         stats[0].lag[burst].merge(stats[r].lag[burst]);
+         stats[0].overruns[burst] += stats[r].overruns[burst];
+      }
+   }
+   for(int burst = 1; burst >= 0; --burst) {
+      const auto& latency = stats[0].latency[burst];
+      const auto& lag = stats[0].lag[burst];
+      if(latency.count() == 0) {
+         continue;
+      }
+      std::printf("%9u %-7s %10llu %9.0f %9.0f %9.0f %8llu %8llu %8llu %10llu\n", capacity, burst ? "burst" : "steady",
+         static_cast<unsigned long long>(latency.count()), clock.to_ns(latency.percentile(50)), clock.to_ns(latency.percentile(99)),
+         clock.to_ns(latency.max()), static_cast<unsigned long long>(lag.percentile(50)), static_cast<unsigned long long>(lag.percentile(99)),
+         static_cast<unsigned long long>(lag.max()), static_cast<unsigned long long>(stats[0].overruns[burst]));
+   }
+   const std::uint64_t max_lag = std::max(stats[0].lag[0].max(), stats[0].lag[1].max());
+   if(stats[0].overruns[0] + stats[0].overruns[1] != 0 || max_lag >= capacity) {
+      std::printf("%9s readers were overtaken, a capacity of at least %llu is suggested\n", "",
+         static_cast<unsigned long long>(std::bit_ceil(std::max<std::uint64_t>(max_lag + 1, 2 * capacity))));
+   }
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   const std::string mode = args.get("mode", std::string{"profile"});
+   const double rate = args.get("rate", std::uint64_t{1000000});
+   const double duration_ms = args.get("duration-ms", std::uint64_t{1000});
+   std::vector<Segment> segments;
+   if(mode == "profile") {
+      const std::string path = args.get("profile", std::string{});
+      segments = path.empty() ? market_open_profile : read_profile(path);
+   }
+   else if(mode == "constant" || mode == "poisson") {
+      segments = {{duration_ms, rate}};
+   }
+   else {
+      std::printf("unknown mode %s, expected constant, poisson or profile\n", mode.c_str());
+      return 1;
+   }
+   const Schedule schedule = make_schedule(segments, mode != "constant", clock, args.get("seed", std::uint64_t{1}));
+   if(schedule.arrivals.empty()) {
+      std::printf("the arrival schedule is empty\n");
+      return 1;
+   }
+   std::printf("mode %s, %zu messages over %.0f ms, 64 B payload\n", mode.c_str(), schedule.arrivals.size(),
+      clock.to_ns(schedule.arrivals.back()) / 1e6);
+   std::printf("%9s %-7s %10s %9s %9s %9s %8s %8s %8s %10s\n", "capacity", "phase", "messages", "p50 ns", "p99 ns", "max ns",
+      "lag p50", "lag p99", "lag max", "overruns");
+   run_capacity<1 << 8>(args, schedule, clock);
+   run_capacity<1 << 10>(args, schedule, clock);
+   run_capacity<1 << 12>(args, schedule, clock);
+   run_capacity<1 << 14>(args, schedule, clock);
+   run_capacity<1 << 16>(args, schedule, clock);
+}
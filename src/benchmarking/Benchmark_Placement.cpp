@@ -0,0 +1,117 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+#include "Topology.hpp"
+
+// throughput and latency of SeqLockQueue for each placement class of producer and readers: readers on the producer's
+// SMT sibling, on another core sharing the producer's L3 cache, on a core with a different L3 cache (e.g. another CCX)
+// and on another socket. prints a recommendation based on the results
+// usage: Benchmark_Placement [--readers n] [--messages n] [--latency-messages n] [--interval-ns n] [--round-trips n]
+//                            [--sysfs path]
+// placement classes the machine doesn't provide for the requested number of readers are skipped
+
+using Bench_Auxil::Arguments;
+
+using PayloadType = Bench_Auxil::Payload<64>;
+using ThroughputQueueType = Queue::SeqLockQueue<PayloadType, 1 << 16, false, false>;
+using LatencyQueueType = Queue::SeqLockQueue<PayloadType, 1 << 12, false, false>;
+
+struct PlacementResult {
+   double reader_msgs_per_s = 0;
+   double one_way_p50_ns = 0;
+   double one_way_p99_ns = 0;
+   double round_trip_p50_ns = 0;
+};
+
+std::string cpu_list(const std::vector<unsigned>& cpus) {
+   std::string ret;
+   for(std::size_t i = 0; i < cpus.size(); ++i) {
+      ret += (i ? "," : "") + std::to_string(cpus[i]);
+   }
+   return ret;
+};
+
+// where readers go relative to the producer, as part of a sentence
+static constexpr std::array<const char*, Topology::n_placements> placement_phrases = {
+   "on the SMT sibling of", "on other cores sharing the L3 cache of", "on cores with a different L3 cache than", "on another socket than"};
+
+PlacementResult run_placement(const Arguments& args, const Bench_Auxil::TscClock& clock, const unsigned n_readers,
+   const std::vector<unsigned>& cpus) {
+   PlacementResult ret;
+   const std::uint64_t n_messages = args.get("messages", std::uint64_t{1} << 24);
+   auto throughput_queue = std::make_unique<ThroughputQueueType>();
+   const auto throughput = Bench_Auxil::run_throughput(*throughput_queue, n_readers, n_messages, cpus);
+   for(unsigned r = 0; r < n_readers; ++r) {
+      ret.reader_msgs_per_s += throughput.reader_messages[r] / throughput.reader_seconds[r] / n_readers;
+   }
+
+   auto latency_queue = std::make_unique<LatencyQueueType>();
+   const auto one_way = Bench_Auxil::run_one_way_latency(*latency_queue, n_readers, args.get("latency-messages", std::uint64_t{1} << 18),
+      clock.to_ticks(args.get("interval-ns", std::uint64_t{1000})), cpus);
+   ret.one_way_p50_ns = clock.to_ns(one_way.percentile(50));
+   ret.one_way_p99_ns = clock.to_ns(one_way.percentile(99));
+
+   auto ping_queue = std::make_unique<LatencyQueueType>();
+   auto pong_queue = std::make_unique<LatencyQueueType>();
+   const auto round_trip = Bench_Auxil::run_round_trip(*ping_queue, *pong_queue, args.get("round-trips", std::uint64_t{1} << 18), cpus);
+   ret.round_trip_p50_ns = clock.to_ns(round_trip.percentile(50));
+   return ret;
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   const unsigned n_readers = args.get("readers", std::uint64_t{1});
+   const auto topology = Topology::read_topology(args.get("sysfs", std::string{"/sys/devices/system/cpu"}));
+   if(topology.empty()) {
+      std::printf("could not read cpu topology\n");
+      return 1;
+   }
+   std::printf("%zu cpus, %u reader(s), 64 B payload\n", topology.size(), n_readers);
+   std::printf("%-13s %-20s %14s %13s %13s %15s\n", "placement", "cpus (producer,...)", "reader msgs/s", "one-way p50", "one-way p99",
+      "round trip p50");
+
+   std::array<std::optional<PlacementResult>, Topology::n_placements> results;
+   std::array<std::vector<unsigned>, Topology::n_placements> placements;
+   for(std::size_t p = 0; p < Topology::n_placements; ++p) {
+      const auto placement = static_cast<Topology::Placement>(p);
+      const auto cpus = Topology::placement_cpus(topology, placement, n_readers);
+      if(!cpus.has_value()) {
+         std::printf("%-13s not available on this machine\n", Topology::placement_names[p]);
+         continue;
+      }
+      placements[p] = cpus.value();
+      results[p] = run_placement(args, clock, n_readers, cpus.value());
+      std::printf("%-13s %-20s %14.3e %10.0f ns %10.0f ns %12.0f ns\n", Topology::placement_names[p], cpu_list(cpus.value()).c_str(),
+         results[p]->reader_msgs_per_s, results[p]->one_way_p50_ns, results[p]->one_way_p99_ns, results[p]->round_trip_p50_ns);
+   }
+
+   std::optional<std::size_t> best_latency;
+   std::optional<std::size_t> best_throughput;
+   for(std::size_t p = 0; p < Topology::n_placements; ++p) {
+      if(!results[p].has_value()) {
+         continue;
+      }
+      if(!best_latency.has_value() || results[p]->one_way_p50_ns < results[best_latency.value()]->one_way_p50_ns) {
+         best_latency = p;
+      }
+      if(!best_throughput.has_value() || results[p]->reader_msgs_per_s > results[best_throughput.value()]->reader_msgs_per_s) {
+         best_throughput = p;
+      }
+   }
+   if(!best_latency.has_value()) {
+      std::printf("no placement class available, at least two cpus are required\n");
+      return 0;
+   }
+   std::printf("recommendation: for lowest latency place readers %s the producer (e.g. cpus %s)\n",
+      placement_phrases[best_latency.value()], cpu_list(placements[best_latency.value()]).c_str());
+   std::printf("                for highest reader throughput place readers %s the producer (e.g. cpus %s)\n",
+      placement_phrases[best_throughput.value()], cpu_list(placements[best_throughput.value()]).c_str());
+}
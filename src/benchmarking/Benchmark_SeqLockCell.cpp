@@ -0,0 +1,128 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Bench_Auxil.hpp"
+#include "Cell.hpp"
+
+// reader throughput of Cell::SeqLockCell while a writer keeps storing new values, for both load() (every call copies
+// the value) and load_if_changed() (copies only new values), per payload size, copy engine and number of readers
+// usage: Benchmark_SeqLockCell [--readers n] [--duration-ms n] [--writer-interval-ns n] [--payload bytes]
+// --writer-interval-ns 0 (the default) stores back-to-back, i.e. maximal writer pressure
+
+using Bench_Auxil::Arguments;
+using Bench_Auxil::Payload;
+
+struct CellResult {
+   double loads_per_s = 0;
+   // fraction of the values stored that readers observed, load_if_changed only
+   double updates_seen = 0;
+   double stores_per_s = 0;
+};
+
+template<typename CellType, bool if_changed>
+CellResult run_cell(const Arguments& args, const Bench_Auxil::TscClock& clock, const unsigned n_readers) {
+   using PayloadType = CellType::ValueType;
+   auto cell = std::make_unique<CellType>();
+   const auto duration = std::chrono::milliseconds(args.get("duration-ms", std::uint64_t{200}));
+   const std::uint64_t interval_ticks = clock.to_ticks(args.get("writer-interval-ns", std::uint64_t{0}));
+   std::atomic<unsigned> readers_ready = 0;
+   std::atomic<bool> start = false;
+   std::atomic<bool> stop = false;
+   // keeps the loaded values from being optimized away
+   std::atomic<std::uint64_t> sink_total = 0;
+   std::vector<std::uint64_t> loads(n_readers);
+   std::vector<std::uint64_t> updates(n_readers);
+   std::vector<double> seconds(n_readers);
+   std::vector<std::jthread> readers;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      readers.emplace_back([&, r]() {
+         std::uint64_t n_loads = 0;
+         std::uint64_t n_updates = 0;
+         std::uint64_t sink = 0;
+         std::int64_t last_version = CellType::initial_version;
+         readers_ready.fetch_add(1);
+         while(!start.load(std::memory_order_acquire));
+         const auto begin = std::chrono::steady_clock::now();
+         while(!stop.load(std::memory_order_relaxed)) {
+            if constexpr(if_changed) {
+               const auto value = cell->load_if_changed(last_version);
+               n_updates += value.has_value();
+               sink += value.has_value() ? value->sequence() : 0;
+            }
+            else {
+               sink += cell->load().sequence();
+            }
+            ++n_loads;
+         }
+         seconds[r] = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+         sink_total.fetch_add(sink, std::memory_order_relaxed);
+         loads[r] = n_loads;
+         updates[r] = n_updates;
+      });
+   }
+   while(readers_ready.load() != n_readers);
+   start.store(true, std::memory_order_release);
+   const auto begin = std::chrono::steady_clock::now();
+   PayloadType value;
+   std::uint64_t n_stores = 0;
+   while(std::chrono::steady_clock::now() - begin < duration) {
+      // checking the clock every 64 stores keeps its cost out of the writer's rate
+      for(unsigned i = 0; i < 64; ++i) {
+         value.stamp(++n_stores);
+         cell->store(value);
+         if(interval_ticks > 0) {
+            const std::uint64_t next = Bench_Auxil::read_tsc() + interval_ticks;
+            while(Bench_Auxil::read_tsc() < next);
+         }
+      }
+   }
+   const double writer_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+   stop.store(true, std::memory_order_relaxed);
+   readers.clear();
+   CellResult result;
+   result.stores_per_s = n_stores / writer_seconds;
+   for(unsigned r = 0; r < n_readers; ++r) {
+      result.loads_per_s += loads[r] / seconds[r] / n_readers;
+      result.updates_seen += static_cast<double>(updates[r]) / n_stores / n_readers;
+   }
+   return result;
+};
+
+template<typename CellType>
+void measure(const Arguments& args, const Bench_Auxil::TscClock& clock, const char* configuration) {
+   const unsigned max_readers = args.get("readers", std::uint64_t{Bench_Auxil::default_max_readers()});
+   for(unsigned n_readers = 1; n_readers <= max_readers; ++n_readers) {
+      const CellResult loaded = run_cell<CellType, false>(args, clock, n_readers);
+      const CellResult changed = run_cell<CellType, true>(args, clock, n_readers);
+      std::printf("%-28s %7u %14.3e %14.3e %14.3e %10.4f\n", configuration, n_readers, loaded.stores_per_s, loaded.loads_per_s,
+         changed.loads_per_s, changed.updates_seen);
+   }
+};
+
+template<std::size_t payload_size>
+void measure_payload(const Arguments& args, const Bench_Auxil::TscClock& clock) {
+   if(!args.selected("payload", payload_size)) {
+      return;
+   }
+   using PayloadType = Payload<payload_size>;
+   const std::string size = std::to_string(payload_size) + " B";
+   measure<Cell::SeqLockCell<PayloadType, true>>(args, clock, (size + ", UB").c_str());
+   measure<Cell::SeqLockCell<PayloadType, false>>(args, clock, (size + ", no UB").c_str());
+   measure<Cell::SeqLockCell<PayloadType, true, true>>(args, clock, (size + ", UB, double buffer").c_str());
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   const Bench_Auxil::TscClock clock;
+   std::printf("%-28s %7s %14s %14s %14s %10s\n", "payload, configuration", "readers", "stores/s", "load/s", "if_changed/s",
+      "seen");
+   measure_payload<8>(args, clock);
+   measure_payload<64>(args, clock);
+   measure_payload<512>(args, clock);
+}
@@ -0,0 +1,119 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include <tuple>
+
+#include "Element.hpp"
+#include "SLQ_Auxil.hpp"
+
+// compares the per-operation cost of SeqLockElement's insert and read against the memory ordering scheme it used before
+// (fetch_add on both version bumps, read storing the final version into a local atomic)
+
+namespace Legacy {
+template<typename ContentType, std::uint32_t alignment>
+struct alignas(alignment) SeqLockElement {
+   using PayloadType = ContentType::type;
+   ContentType content;
+   std::atomic<std::int64_t> version = 0;
+
+   void insert(const PayloadType& new_content) noexcept {
+      this->version.fetch_add(1, std::memory_order_acquire);
+      this->content = ContentType(new_content);
+      this->version.fetch_add(1, std::memory_order_release);
+   };
+
+   std::tuple<std::optional<PayloadType>, std::int64_t> read(const std::int64_t prev_version) const noexcept {
+      std::tuple<std::optional<ContentType>, std::int64_t> ret;
+      std::optional<ContentType>& ret_opt = std::get<0>(ret);
+      std::int64_t& initial_version = std::get<1>(ret);
+      std::atomic<std::int64_t> final_version;
+      do {
+         initial_version = this->version.load(std::memory_order_acquire);
+         ret_opt = this->content;
+         final_version.store(this->version, std::memory_order_release);
+      }
+      while(initial_version % 2 || (initial_version != final_version));
+      ret_opt = initial_version >= prev_version ? ret_opt : std::nullopt;
+      return ret;
+   };
+};
+}
+
+template<std::size_t size>
+struct Payload {
+   std::array<std::uint8_t, size> bytes;
+   Payload(std::uint8_t fill = 0) noexcept { bytes.fill(fill); };
+};
+
+static constexpr std::uint64_t n_ops = 1 << 22;
+
+template<typename F>
+double ns_per_op(F&& f) {
+   const auto start = std::chrono::steady_clock::now();
+   f();
+   const auto stop = std::chrono::steady_clock::now();
+   return std::chrono::duration<double, std::nano>(stop - start).count() / n_ops;
+};
+
+template<typename ElementType>
+void run_case(const char* implementation, const char* payload) {
+   using PayloadType = ElementType::PayloadType;
+   auto element = new ElementType();
+   std::uint64_t sink = 0;
+
+   const double insert_ns = ns_per_op([&]() {
+      for(std::uint64_t i = 0; i < n_ops; ++i) {
+         element->insert(PayloadType(static_cast<std::uint8_t>(i)));
+      }
+   });
+
+   const double read_ns = ns_per_op([&]() {
+      for(std::uint64_t i = 0; i < n_ops; ++i) {
+         const auto [read_opt, read_version] = element->read(0);
+         sink += read_version + read_opt->bytes.back();
+      }
+   });
+
+   // insert while another thread keeps polling the element, i.e. the cacheline keeps bouncing between cores
+   std::atomic<bool> stop{false};
+   std::thread poller([&]() {
+      std::uint64_t local_sink = 0;
+      while(!stop.load(std::memory_order_relaxed)) {
+         const auto [read_opt, read_version] = element->read(0);
+         local_sink += read_version + read_opt->bytes.back();
+      }
+      sink += local_sink;
+   });
+   const double contended_insert_ns = ns_per_op([&]() {
+      for(std::uint64_t i = 0; i < n_ops; ++i) {
+         element->insert(PayloadType(static_cast<std::uint8_t>(i)));
+      }
+   });
+   stop.store(true, std::memory_order_relaxed);
+   poller.join();
+
+   std::printf("%-8s %-22s %10.2f %10.2f %18.2f   (%llu)\n", implementation, payload, insert_ns, read_ns, contended_insert_ns,
+      static_cast<unsigned long long>(sink % 10));
+   delete element;
+};
+
+template<std::size_t size, bool accept_UB>
+void compare(const char* payload) {
+   using ContentType = SLQ_Auxil::UB_or_not_UB<Payload<size>, accept_UB>;
+   run_case<Legacy::SeqLockElement<ContentType, 64>>("before", payload);
+   run_case<Element::SeqLockElement<ContentType, 64>>("after", payload);
+};
+
+int main() {
+   std::printf("%-8s %-22s %10s %10s %18s\n", "", "payload", "insert ns", "read ns", "contended insert ns");
+   compare<8, true>("8 bytes, UB");
+   compare<8, false>("8 bytes, no UB");
+   compare<48, true>("48 bytes, UB");
+   compare<48, false>("48 bytes, no UB");
+   compare<256, true>("256 bytes, UB");
+   compare<256, false>("256 bytes, no UB");
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <utility>
+
+#include "Bench_Auxil.hpp"
+#include "Queue.hpp"
+
+// sweeps SeqLockQueue throughput across payload size, buffer size, share_cacheline, accept_UB and number of readers
+// usage: Benchmark_Throughput [--csv file] [--messages n] [--max-readers n] [--payload bytes] [--footprint KB]
+//                             [--share-cacheline 0|1] [--accept-ub 0|1] [--counters 0|1]
+//                             [--json file] [--baseline file] [--save-baseline 0|1] [--threshold-pct n]
+// buffer sizes are given as the size of the ring buffer, elements including their version and padding, from
+// L1-resident to DRAM-sized
+// hardware counters (see PerfCounters.hpp) are reported per message for the producer and across all readers' messages
+// producer and mean reader throughput of every configuration are compared to the host's baseline (see History.hpp)
+
+using Bench_Auxil::Arguments;
+using Bench_Auxil::CsvWriter;
+
+static const std::string csv_header =
+   "payload_bytes,length,share_cacheline,accept_UB,readers,producer_msgs_per_s,producer_bytes_per_s,"
+   "reader_msgs_per_s_mean,reader_msgs_per_s_min,reader_bytes_per_s_mean,reader_overrun_fraction,"
+   + Bench_Auxil::counters_csv_header("producer_") + "," + Bench_Auxil::counters_csv_header("reader_");
+
+template<std::size_t payload_size, std::size_t footprint_KB, bool share_cacheline, bool accept_UB>
+void run_configuration(const Arguments& args, CsvWriter& csv, History::Results& history) {
+   if(!args.selected("payload", payload_size) || !args.selected("footprint", footprint_KB)
+      || !args.selected("share-cacheline", share_cacheline) || !args.selected("accept-ub", accept_UB)) {
+      return;
+   }
+   using PayloadType = Bench_Auxil::Payload<payload_size>;
+   // the element size depends on the layout but not on the length, an element without shared cachelines takes up at
+   // least 64 bytes whatever the payload
+   static constexpr std::size_t element_size = Queue::SeqLockQueue<PayloadType, 2, share_cacheline, accept_UB>::element_size;
+   static constexpr std::uint32_t length = std::max<std::size_t>(2, std::bit_floor(footprint_KB * 1024 / element_size));
+   using QueueType = Queue::SeqLockQueue<PayloadType, length, share_cacheline, accept_UB>;
+   static_assert(QueueType::footprint <= footprint_KB * 1024 || length == 2);
+   const std::uint64_t n_messages = args.get("messages", std::max<std::uint64_t>(std::uint64_t{1} << 22, 4 * std::uint64_t{length}));
+   const unsigned max_readers = args.get("max-readers", std::uint64_t{Bench_Auxil::default_max_readers()});
+
+   for(unsigned n_readers = 1; n_readers <= max_readers; ++n_readers) {
+      auto queue = std::make_unique<QueueType>();
+      const auto result = Bench_Auxil::run_throughput(*queue, n_readers, n_messages);
+      const double producer_rate = n_messages / result.producer_seconds;
+      double reader_rate_sum = 0;
+      double reader_rate_min = producer_rate;
+      std::uint64_t overruns = 0;
+      std::uint64_t reader_messages = 0;
+      PerfCounters::CounterValues reader_counters;
+      for(unsigned r = 0; r < n_readers; ++r) {
+         const double rate = result.reader_messages[r] / result.reader_seconds[r];
+         reader_rate_sum += rate;
+         reader_rate_min = std::min(reader_rate_min, rate);
+         overruns += result.reader_overruns[r];
+         reader_messages += result.reader_messages[r];
+         reader_counters += result.reader_counters[r];
+      }
+      const double reader_rate_mean = reader_rate_sum / n_readers;
+      const double overrun_fraction = static_cast<double>(overruns) / (static_cast<double>(n_messages) * n_readers);
+      std::printf("%8zu %10u %6d %6d %8u %14.2f %10.2f %14.2f %10.2f %10.4f\n", payload_size, length, share_cacheline, accept_UB,
+         n_readers, producer_rate / 1e6, producer_rate * payload_size / 1e9, reader_rate_mean / 1e6,
+         reader_rate_mean * payload_size / 1e9, overrun_fraction);
+      if(args.get("counters", std::uint64_t{1}) && PerfCounters::CounterGroup().available()) {
+         Bench_Auxil::print_counters("producer per message:", result.producer_counters, n_messages);
+         Bench_Auxil::print_counters("reader per message:", reader_counters, std::max<std::uint64_t>(1, reader_messages));
+      }
+      const std::string configuration = "payload=" + std::to_string(payload_size) + ",length=" + std::to_string(length)
+         + ",share_cacheline=" + std::to_string(share_cacheline) + ",accept_UB=" + std::to_string(accept_UB) + ",readers="
+         + std::to_string(n_readers);
+      history.add(configuration + "/producer_msgs_per_s", producer_rate, true);
+      history.add(configuration + "/reader_msgs_per_s_mean", reader_rate_mean, true);
+      csv.write_row(std::to_string(payload_size) + "," + std::to_string(length) + "," + std::to_string(share_cacheline) + ","
+         + std::to_string(accept_UB) + "," + std::to_string(n_readers) + "," + std::to_string(producer_rate) + ","
+         + std::to_string(producer_rate * payload_size) + "," + std::to_string(reader_rate_mean) + "," + std::to_string(reader_rate_min)
+         + "," + std::to_string(reader_rate_mean * payload_size) + "," + std::to_string(overrun_fraction) + ","
+         + Bench_Auxil::counters_csv(result.producer_counters, n_messages) + ","
+         + Bench_Auxil::counters_csv(reader_counters, std::max<std::uint64_t>(1, reader_messages)));
+   }
+};
+
+template<std::size_t payload_size, std::size_t footprint_KB>
+void run_layouts(const Arguments& args, CsvWriter& csv, History::Results& history) {
+   run_configuration<payload_size, footprint_KB, true, true>(args, csv, history);
+   run_configuration<payload_size, footprint_KB, true, false>(args, csv, history);
+   run_configuration<payload_size, footprint_KB, false, true>(args, csv, history);
+   run_configuration<payload_size, footprint_KB, false, false>(args, csv, history);
+};
+
+template<std::size_t payload_size, std::size_t... footprints_KB>
+void run_footprints(const Arguments& args, CsvWriter& csv, History::Results& history, std::index_sequence<footprints_KB...>) {
+   (run_layouts<payload_size, footprints_KB>(args, csv, history), ...);
+};
+
+template<std::size_t... payload_sizes>
+void run_payloads(const Arguments& args, CsvWriter& csv, History::Results& history, std::index_sequence<payload_sizes...>) {
+   // 16 KB: L1, 256 KB: L2, 8 MB: LLC, 256 MB: DRAM
+   (run_footprints<payload_sizes>(args, csv, history, std::index_sequence<16, 256, 8 * 1024, 256 * 1024>{}), ...);
+};
+
+int main(int argc, char** argv) {
+   const Arguments args(argc, argv);
+   if(!PerfCounters::CounterGroup().available()) {
+      std::printf("hardware performance counters unavailable (check /proc/sys/kernel/perf_event_paranoid), reporting n/a\n");
+   }
+   CsvWriter csv(args.get("csv", std::string{}), csv_header);
+   std::printf("%8s %10s %6s %6s %8s %14s %10s %14s %10s %10s\n", "payload", "length", "share", "UB", "readers", "prod Mmsg/s",
+      "prod GB/s", "reader Mmsg/s", "reader GB/s", "overruns");
+   History::Results history;
+   history.benchmark = "Benchmark_Throughput";
+   run_payloads(args, csv, history, std::index_sequence<4, 16, 64, 256, 1024>{});
+   return Bench_Auxil::process_history(args, history);
+}
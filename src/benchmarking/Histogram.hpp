@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+namespace Histogram {
+// log-linear histogram in the style of HdrHistogram: values below 2 * sub_buckets are counted exactly, above that every
+// power-of-two range is split into sub_buckets equally sized buckets, i.e. the relative error is below 1 / sub_buckets
+template<std::uint32_t sub_bucket_bits = 7>
+struct HdrHistogram {
+private:
+   static constexpr std::uint64_t sub_buckets = std::uint64_t{1} << (sub_bucket_bits - 1);
+   static constexpr std::uint64_t exact_limit = 2 * sub_buckets;
+   static constexpr std::size_t n_buckets = (64 - sub_bucket_bits + 1) * sub_buckets + sub_buckets;
+   std::array<std::uint64_t, n_buckets> counts{};
+   std::uint64_t total = 0;
+   std::uint64_t min_value = std::numeric_limits<std::uint64_t>::max();
+   std::uint64_t max_value = 0;
+   double sum = 0;
+
+   static constexpr std::size_t bucket_index(const std::uint64_t value) noexcept {
+      if(value < exact_limit) {
+         return value;
+      }
+      const std::uint32_t shift = std::bit_width(value) - sub_bucket_bits;
+      return shift * sub_buckets + (value >> shift);
+   };
+
+   // largest value that is counted in bucket index
+   static constexpr std::uint64_t highest_equivalent(const std::size_t index) noexcept {
+      if(index < exact_limit) {
+         return index;
+      }
+      const std::uint64_t shift = index / sub_buckets - 1;
+      const std::uint64_t sub_bucket = index % sub_buckets + sub_buckets;
+      return ((sub_bucket + 1) << shift) - 1;
+   };
+
+public:
+   void record(const std::uint64_t value) noexcept {
+      ++this->counts[bucket_index(value)];
+      ++this->total;
+      this->min_value = std::min(this->min_value, value);
+      this->max_value = std::max(this->max_value, value);
+      this->sum += value;
+   };
+
+   void merge(const HdrHistogram& other) noexcept {
+      for(std::size_t i = 0; i < n_buckets; ++i) {
+         this->counts[i] += other.counts[i];
+      }
+      this->total += other.total;
+      this->min_value = std::min(this->min_value, other.min_value);
+      this->max_value = std::max(this->max_value, other.max_value);
+      this->sum += other.sum;
+   };
+
+   void reset() noexcept {
+      *this = HdrHistogram{};
+   };
+
+   std::uint64_t count() const noexcept { return this->total; };
+   std::uint64_t min() const noexcept { return this->total ? this->min_value : 0; };
+   std::uint64_t max() const noexcept { return this->max_value; };
+   double mean() const noexcept { return this->total ? this->sum / this->total : 0; };
+
+   // smallest value that percentile percent of all recorded values are less than or equal to (within bucket precision)
+   std::uint64_t percentile(const double percentile) const noexcept {
+      if(this->total == 0) {
+         return 0;
+      }
+      const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(percentile / 100.0 * this->total + 0.5));
+      std::uint64_t seen = 0;
+      for(std::size_t i = 0; i < n_buckets; ++i) {
+         seen += this->counts[i];
+         if(seen >= rank) {
+            return std::min(highest_equivalent(i), this->max_value);
+         }
+      }
+      return this->max_value;
+   };
+};
+} // namespace Histogram
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// machine-readable benchmark results (JSON) and comparison against a stored baseline of a previous run on the same host
+namespace History {
+struct Metric {
+   std::string name;
+   double value = 0;
+   // e.g. true for throughput, false for latency
+   bool higher_is_better = true;
+};
+
+inline std::string host_name() {
+#if defined(__linux__)
+   char name[256] = {};
+   if(gethostname(name, sizeof(name) - 1) == 0) {
+      return name;
+   }
+#endif
+   return "unknown_host";
+};
+
+struct Results {
+   std::string benchmark;
+   std::string host = host_name();
+   std::int64_t timestamp = std::time(nullptr);
+   std::vector<Metric> metrics;
+
+   void add(const std::string& name, const double value, const bool higher_is_better) {
+      this->metrics.push_back({name, value, higher_is_better});
+   };
+
+   const Metric* find(const std::string& name) const noexcept {
+      for(const Metric& metric : this->metrics) {
+         if(metric.name == name) {
+            return &metric;
+         }
+      }
+      return nullptr;
+   };
+
+   std::string to_json() const {
+      std::ostringstream out;
+      out.precision(17);
+      out << "{\n  \"benchmark\": \"" << this->benchmark << "\",\n  \"host\": \"" << this->host << "\",\n  \"timestamp\": "
+          << this->timestamp << ",\n  \"metrics\": [";
+      for(std::size_t i = 0; i < this->metrics.size(); ++i) {
+         const Metric& metric = this->metrics[i];
+         out << (i ? ",\n" : "\n") << "    {\"name\": \"" << metric.name << "\", \"value\": " << metric.value
+             << ", \"higher_is_better\": " << (metric.higher_is_better ? "true" : "false") << "}";
+      }
+      out << "\n  ]\n}\n";
+      return out.str();
+   };
+
+   bool write(const std::string& path) const {
+      const std::filesystem::path file_path(path);
+      if(file_path.has_parent_path()) {
+         std::error_code error;
+         std::filesystem::create_directories(file_path.parent_path(), error);
+      }
+      std::ofstream file(path);
+      file << this->to_json();
+      return static_cast<bool>(file);
+   };
+};
+
+// value of "key": in a single-line JSON object as written by Results::to_json, strings without escape sequences only
+inline std::optional<std::string> json_field(const std::string& object, const std::string& key) {
+   const std::string pattern = "\"" + key + "\":";
+   std::size_t pos = object.find(pattern);
+   if(pos == std::string::npos) {
+      return std::nullopt;
+   }
+   pos = object.find_first_not_of(' ', pos + pattern.size());
+   if(pos == std::string::npos) {
+      return std::nullopt;
+   }
+   if(object[pos] == '"') {
+      const std::size_t end = object.find('"', pos + 1);
+      return end == std::string::npos ? std::nullopt : std::optional<std::string>{object.substr(pos + 1, end - pos - 1)};
+   }
+   const std::size_t end = object.find_first_of(",}\n", pos);
+   return object.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+};
+
+// reads results written by Results::write, nullopt if the file doesn't exist or isn't in that format
+inline std::optional<Results> read(const std::string& path) {
+   std::ifstream file(path);
+   if(!file) {
+      return std::nullopt;
+   }
+   Results ret;
+   ret.metrics.clear();
+   std::string line;
+   while(std::getline(file, line)) {
+      if(line.find("\"name\":") != std::string::npos) {
+         const auto name = json_field(line, "name");
+         const auto value = json_field(line, "value");
+         const auto higher_is_better = json_field(line, "higher_is_better");
+         if(!name.has_value() || !value.has_value() || !higher_is_better.has_value()) {
+            return std::nullopt;
+         }
+         ret.add(name.value(), std::stod(value.value()), higher_is_better.value() == "true");
+      }
+      else if(const auto benchmark = json_field(line, "benchmark")) {
+         ret.benchmark = benchmark.value();
+      }
+      else if(const auto host = json_field(line, "host")) {
+         ret.host = host.value();
+      }
+      else if(const auto timestamp = json_field(line, "timestamp")) {
+         ret.timestamp = std::stoll(timestamp.value());
+      }
+   }
+   return ret;
+};
+
+// prints every metric present in both result sets whose change exceeds threshold (relative, e.g. 0.05), returns the
+// number of metrics that got worse by more than threshold
+inline unsigned compare(const Results& baseline, const Results& current, const double threshold) {
+   unsigned regressions = 0;
+   unsigned compared = 0;
+   for(const Metric& metric : current.metrics) {
+      const Metric* base = baseline.find(metric.name);
+      if(base == nullptr || base->value == 0) {
+         continue;
+      }
+      ++compared;
+      const double change = (metric.value - base->value) / std::abs(base->value);
+      const double improvement = metric.higher_is_better ? change : -change;
+      if(std::abs(change) <= threshold) {
+         continue;
+      }
+      const bool regression = improvement < 0;
+      regressions += regression;
+      std::printf("%-11s %-64s %14.4g -> %14.4g (%+.1f%%)\n", regression ? "REGRESSION" : "improvement", metric.name.c_str(),
+         base->value, metric.value, 100 * change);
+   }
+   std::printf("compared %u metrics against the baseline of %s, %u regression(s) beyond %.1f%%\n", compared, baseline.host.c_str(),
+      regressions, 100 * threshold);
+   return regressions;
+};
+
+// default location of the baseline of a benchmark on this host, relative to the working directory
+inline std::string default_baseline_path(const std::string& benchmark) {
+   return "history/" + benchmark + "_" + host_name() + ".json";
+};
+
+// writes results to json_path (if not empty), compares them to the baseline at baseline_path and stores them as the new
+// baseline if there is none yet or save_baseline is set. returns the number of regressions
+inline unsigned process(const Results& results, const std::string& json_path, const std::string& baseline_path,
+   const bool save_baseline, const double threshold) {
+   if(!json_path.empty() && !results.write(json_path)) {
+      std::fprintf(stderr, "could not write %s\n", json_path.c_str());
+   }
+   unsigned regressions = 0;
+   const auto baseline = read(baseline_path);
+   if(baseline.has_value()) {
+      regressions = compare(baseline.value(), results, threshold);
+   }
+   if(!baseline.has_value() || save_baseline) {
+      if(results.write(baseline_path)) {
+         std::printf("stored results as baseline in %s\n", baseline_path.c_str());
+      }
+      else {
+         std::fprintf(stderr, "could not write %s\n", baseline_path.c_str());
+      }
+   }
+   return regressions;
+};
+} // namespace History
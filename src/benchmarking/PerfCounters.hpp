@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace PerfCounters {
+enum Counter : std::size_t {
+   cycles,
+   instructions,
+   l1d_misses,
+   llc_misses,
+   dtlb_misses,
+   // loads served from a cacheline modified in another core's private cache
+   remote_hitm,
+   n_counters
+};
+
+inline constexpr std::array<const char*, n_counters> counter_names = {
+   "cycles", "instructions", "L1D_misses", "LLC_misses", "dTLB_misses", "remote_HITM"};
+
+// counter values of a measured region, counters that couldn't be opened hold no value
+struct CounterValues {
+   std::array<std::optional<std::uint64_t>, n_counters> values;
+
+   CounterValues& operator+=(const CounterValues& other) noexcept {
+      for(std::size_t i = 0; i < n_counters; ++i) {
+         if(other.values[i].has_value()) {
+            this->values[i] = this->values[i].value_or(0) + other.values[i].value();
+         }
+      }
+      return *this;
+   };
+
+   // value of a counter divided by n, e.g. the number of messages, -1 if the counter isn't available
+   double per(const Counter counter, const double n) const noexcept {
+      return this->values[counter].has_value() ? this->values[counter].value() / n : -1;
+   };
+};
+
+// raw event for remote_hitm, can be overridden via the environment variable SLQ_PERF_REMOTE_HITM_RAW (hex), e.g. if the
+// default doesn't apply to a CPU model. defaults to MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM (event 0xd2, umask 0x04) on Intel,
+// there is no default for other vendors
+inline std::optional<std::uint64_t> remote_hitm_raw_event() {
+   if(const char* env = std::getenv("SLQ_PERF_REMOTE_HITM_RAW")) {
+      return std::strtoull(env, nullptr, 16);
+   }
+   std::ifstream cpuinfo("/proc/cpuinfo");
+   std::string line;
+   while(std::getline(cpuinfo, line)) {
+      if(line.rfind("vendor_id", 0) == 0) {
+         return line.find("GenuineIntel") != std::string::npos ? std::optional<std::uint64_t>{0x04d2} : std::nullopt;
+      }
+   }
+   return std::nullopt;
+};
+
+// hardware performance counters of the calling thread, opened as one group so that they are always scheduled onto the
+// PMU together and count the same time window. the first counter opened leads the group, an event that is unsupported
+// or doesn't fit into the group is left out without preventing the others from being counted
+struct CounterGroup {
+private:
+   std::array<int, n_counters> fds;
+   int leader = -1;
+
+#if defined(__linux__)
+   // layout of a counter's value as read() returns it with the read_format below
+   struct ReadFormat {
+      std::uint64_t value;
+      std::uint64_t time_enabled;
+      std::uint64_t time_running;
+   };
+
+   int open_event(const std::uint32_t type, const std::uint64_t config) noexcept {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.config = config;
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      // the group may still be multiplexed with other processes' events, counts are scaled by the fraction of time it
+      // was running
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, this->leader, 0));
+      if(this->leader < 0) {
+         this->leader = fd;
+      }
+      return fd;
+   };
+
+   static constexpr std::uint64_t cache_event(const std::uint64_t cache, const std::uint64_t result) noexcept {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+   };
+#endif
+
+public:
+   explicit CounterGroup() noexcept {
+      this->fds.fill(-1);
+#if defined(__linux__)
+      this->fds[cycles] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+      this->fds[instructions] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+      this->fds[l1d_misses] = open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS));
+      this->fds[llc_misses] = open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS));
+      if(this->fds[llc_misses] < 0) {
+         this->fds[llc_misses] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+      }
+      this->fds[dtlb_misses] = open_event(PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_RESULT_MISS));
+      if(const auto raw_event = remote_hitm_raw_event()) {
+         this->fds[remote_hitm] = open_event(PERF_TYPE_RAW, raw_event.value());
+      }
+#endif
+   };
+
+   ~CounterGroup() {
+#if defined(__linux__)
+      for(const int fd : this->fds) {
+         if(fd >= 0) {
+            close(fd);
+         }
+      }
+#endif
+   };
+
+   CounterGroup(const CounterGroup&) = delete;
+   CounterGroup& operator=(const CounterGroup&) = delete;
+   CounterGroup(CounterGroup&&) = delete;
+   CounterGroup& operator=(CounterGroup&&) = delete;
+
+   // false if none of the counters could be opened, e.g. due to /proc/sys/kernel/perf_event_paranoid or in a container
+   bool available() const noexcept {
+      for(const int fd : this->fds) {
+         if(fd >= 0) {
+            return true;
+         }
+      }
+      return false;
+   };
+
+   void start() noexcept {
+#if defined(__linux__)
+      if(this->leader >= 0) {
+         ioctl(this->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+         ioctl(this->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      }
+#endif
+   };
+
+   // counters that were never scheduled onto the PMU during the measured region hold no value
+   CounterValues stop() noexcept {
+      CounterValues ret;
+#if defined(__linux__)
+      if(this->leader >= 0) {
+         ioctl(this->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+      }
+      for(std::size_t i = 0; i < n_counters; ++i) {
+         ReadFormat counts;
+         if(this->fds[i] < 0 || read(this->fds[i], &counts, sizeof(counts)) != sizeof(counts) || counts.time_running == 0) {
+            continue;
+         }
+         ret.values[i] = counts.time_running == counts.time_enabled ? counts.value
+            : static_cast<std::uint64_t>(static_cast<double>(counts.value) * counts.time_enabled / counts.time_running);
+      }
+#endif
+      return ret;
+   };
+};
+} // namespace PerfCounters
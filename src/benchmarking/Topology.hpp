@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// cpu topology as exposed by linux in /sys/devices/system/cpu and pinning of threads to cpus
+namespace Topology {
+struct Cpu {
+   unsigned id = 0;
+   int package = 0;
+   int core = 0;
+   // lowest cpu sharing the last level (L3) cache, identifies the cache domain (CCX on AMD), -1 if unknown
+   int l3 = -1;
+};
+
+// relationship between the producer's cpu and a reader's cpu, ordered from closest to farthest
+enum Placement : std::size_t {
+   smt_sibling,
+   same_l3,
+   cross_l3,
+   cross_socket,
+   n_placements
+};
+
+inline constexpr std::array<const char*, n_placements> placement_names = {"SMT sibling", "same L3", "cross L3", "cross socket"};
+
+// parses cpu lists of the form 0-3,8,10-11
+inline std::vector<unsigned> parse_cpu_list(const std::string& list) {
+   std::vector<unsigned> ret;
+   std::size_t pos = 0;
+   while(pos < list.size()) {
+      std::size_t end = list.find(',', pos);
+      end = end == std::string::npos ? list.size() : end;
+      const std::string range = list.substr(pos, end - pos);
+      const std::size_t dash = range.find('-');
+      if(!range.empty() && range.find_first_not_of("0123456789-\n ") == std::string::npos) {
+         const unsigned first = std::stoul(range);
+         const unsigned last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+         for(unsigned cpu = first; cpu <= last; ++cpu) {
+            ret.push_back(cpu);
+         }
+      }
+      pos = end + 1;
+   }
+   return ret;
+};
+
+inline std::optional<std::string> read_line(const std::string& path) {
+   std::ifstream file(path);
+   std::string line;
+   if(!std::getline(file, line)) {
+      return std::nullopt;
+   }
+   return line;
+};
+
+// online cpus, empty if the topology can't be read, sysfs_root can be set to read a saved copy of another machine's
+// topology
+inline std::vector<Cpu> read_topology(const std::string& sysfs_root = "/sys/devices/system/cpu") {
+   std::vector<Cpu> ret;
+   const auto online = read_line(sysfs_root + "/online");
+   if(!online.has_value()) {
+      return ret;
+   }
+   for(const unsigned id : parse_cpu_list(online.value())) {
+      const std::string cpu_dir = sysfs_root + "/cpu" + std::to_string(id);
+      Cpu cpu;
+      cpu.id = id;
+      cpu.package = std::stoi(read_line(cpu_dir + "/topology/physical_package_id").value_or("0"));
+      cpu.core = std::stoi(read_line(cpu_dir + "/topology/core_id").value_or(std::to_string(id)));
+      for(unsigned index = 0; index < 8; ++index) {
+         const std::string cache_dir = cpu_dir + "/cache/index" + std::to_string(index);
+         const auto level = read_line(cache_dir + "/level");
+         if(level.has_value() && std::stoi(level.value()) == 3) {
+            const auto shared = parse_cpu_list(read_line(cache_dir + "/shared_cpu_list").value_or(""));
+            cpu.l3 = shared.empty() ? -1 : static_cast<int>(*std::min_element(shared.begin(), shared.end()));
+         }
+      }
+      ret.push_back(cpu);
+   }
+   return ret;
+};
+
+inline Placement classify(const Cpu& a, const Cpu& b) noexcept {
+   if(a.package != b.package) {
+      return cross_socket;
+   }
+   if(a.core == b.core) {
+      return smt_sibling;
+   }
+   // without L3 information the package is assumed to be a single cache domain
+   return (a.l3 == b.l3) ? same_l3 : cross_l3;
+};
+
+// cpus for a producer (first element) and n_readers readers (remaining elements) such that every reader's cpu has the
+// given placement relative to the producer's cpu, nullopt if the machine has no such cpus
+inline std::optional<std::vector<unsigned>> placement_cpus(const std::vector<Cpu>& cpus, const Placement placement,
+   const unsigned n_readers) {
+   for(const Cpu& producer : cpus) {
+      std::vector<unsigned> ret{producer.id};
+      for(const Cpu& reader : cpus) {
+         if(ret.size() == n_readers + 1) {
+            break;
+         }
+         if(reader.id != producer.id && classify(producer, reader) == placement) {
+            ret.push_back(reader.id);
+         }
+      }
+      if(ret.size() == n_readers + 1) {
+         return ret;
+      }
+   }
+   return std::nullopt;
+};
+
+// pins the calling thread to a cpu for the lifetime of the object and restores its previous affinity afterwards
+struct ScopedPin {
+private:
+#if defined(__linux__)
+   cpu_set_t previous;
+   bool pinned = false;
+#endif
+
+public:
+   explicit ScopedPin(const std::optional<unsigned> cpu) noexcept {
+#if defined(__linux__)
+      if(!cpu.has_value() || pthread_getaffinity_np(pthread_self(), sizeof(this->previous), &this->previous) != 0) {
+         return;
+      }
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu.value(), &set);
+      this->pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+      if(!this->pinned) {
+         std::fprintf(stderr, "could not pin thread to cpu %u\n", cpu.value());
+      }
+#endif
+   };
+
+   ~ScopedPin() {
+#if defined(__linux__)
+      if(this->pinned) {
+         pthread_setaffinity_np(pthread_self(), sizeof(this->previous), &this->previous);
+      }
+#endif
+   };
+
+   ScopedPin(const ScopedPin&) = delete;
+   ScopedPin& operator=(const ScopedPin&) = delete;
+   ScopedPin(ScopedPin&&) = delete;
+   ScopedPin& operator=(ScopedPin&&) = delete;
+};
+
+// cpu at index of an optional placement, nullopt (i.e. not pinned) if cpus is empty
+inline std::optional<unsigned> cpu_at(const std::vector<unsigned>& cpus, const std::size_t index) noexcept {
+   return index < cpus.size() ? std::optional<unsigned>{cpus[index]} : std::nullopt;
+};
+} // namespace Topology
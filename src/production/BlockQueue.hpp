@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "Element.hpp"
+#include "SLQ_Auxil.hpp"
+
+namespace Queue {
+template<typename ContentType_, std::uint32_t length_, bool accept_UB>
+requires (std::has_single_bit(length_)) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free && (SLQ_Auxil::block_slots<ContentType_>() >= 2) && (length_ >= SLQ_Auxil::block_slots<ContentType_>())
+struct BlockSeqLockQueue {
+private:
+   static constexpr std::uint32_t length = length_;
+   static constexpr std::uint32_t block_slots = SLQ_Auxil::block_slots<ContentType_>();
+   static constexpr std::uint32_t n_blocks = length / block_slots;
+   using BlockType = Element::SeqLockBlock<SLQ_Auxil::UB_or_not_UB<ContentType_, accept_UB>, block_slots>;
+   using BlockContentType = BlockType::BlockContentType;
+   const std::unique_ptr<BlockType[]> memory_pointer;
+   // data used by dequeueing thread
+   const std::span<BlockType, n_blocks> dequeue_span;
+   // data used by enqueueing thread
+   alignas(SLQ_Auxil::cacheline) std::int64_t enqueue_index = 0;
+   // one past the last entry published, either because its block was filled or by flush()
+   std::int64_t published_index = 0;
+   const std::span<BlockType, n_blocks> enqueue_span;
+
+   struct QueueReader {
+   private:
+      const BlockSeqLockQueue* const queue_ptr;
+      std::int64_t read_index = 0;
+      // entries from read_index up to cached_end_index can be taken from the local copy of the current block
+      std::int64_t cached_end_index = 0;
+      BlockContentType cached_block;
+
+   public:
+      explicit QueueReader(const BlockSeqLockQueue*) noexcept;
+      ~QueueReader() = default;
+      QueueReader(const QueueReader&) = delete;
+      QueueReader& operator=(const QueueReader&) = delete;
+      QueueReader(QueueReader&&) = delete;
+      QueueReader& operator=(QueueReader&&) = delete;
+      std::optional<ContentType_> read_next_entry() noexcept;
+   };
+
+public:
+   using ContentType = ContentType_;
+   static constexpr std::uint32_t slots_per_block = block_slots;
+   explicit BlockSeqLockQueue();
+   ~BlockSeqLockQueue() = default;
+   BlockSeqLockQueue(const BlockSeqLockQueue&) = delete;
+   BlockSeqLockQueue& operator=(const BlockSeqLockQueue&) = delete;
+   BlockSeqLockQueue(BlockSeqLockQueue&&) = delete;
+   BlockSeqLockQueue& operator=(BlockSeqLockQueue&&) = delete;
+   using ReaderType = QueueReader;
+   void enqueue(const ContentType) noexcept;
+   void flush() noexcept;
+   std::optional<std::int64_t> read_block(std::int64_t, BlockContentType&) const noexcept;
+   QueueReader get_reader() const noexcept;
+};
+} // namespace Queue
+
+#define TEMPLATE_PARAMS                                                 \
+   template<typename ContentType_, std::uint32_t length_, bool accept_UB> \
+   requires (std::has_single_bit(length_)) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free && (SLQ_Auxil::block_slots<ContentType_>() >= 2) && (length_ >= SLQ_Auxil::block_slots<ContentType_>())
+
+#define BLOCK_SEQ_LOCK_QUEUE \
+   Queue::BlockSeqLockQueue<ContentType_, length_, accept_UB>
+
+TEMPLATE_PARAMS
+BLOCK_SEQ_LOCK_QUEUE::BlockSeqLockQueue():
+    memory_pointer{new(std::align_val_t{SLQ_Auxil::cacheline}) BlockType[n_blocks]()},
+    dequeue_span{this->memory_pointer.get(), n_blocks},
+    enqueue_span{this->memory_pointer.get(), n_blocks} {};
+
+TEMPLATE_PARAMS
+std::optional<std::int64_t> BLOCK_SEQ_LOCK_QUEUE::read_block(std::int64_t read_index, BlockContentType& dest) const noexcept {
+   return this->dequeue_span[(read_index / block_slots) % n_blocks].read(dest);
+};
+
+TEMPLATE_PARAMS
+void BLOCK_SEQ_LOCK_QUEUE::enqueue(const ContentType_ content_) noexcept {
+   const std::uint32_t slot = this->enqueue_index % block_slots;
+   auto& block = this->enqueue_span[(this->enqueue_index / block_slots) % n_blocks];
+   // version is bumped once when a block is opened at its first slot and once when it is first published, not for
+   // every entry. a block flushed before it was full stays readable while the producer fills the remaining slots
+   if(slot == 0) {
+      block.open();
+   }
+   block.insert(slot, content_);
+   ++this->enqueue_index;
+   if(slot == block_slots - 1) {
+      block.publish(this->enqueue_index);
+      this->published_index = this->enqueue_index;
+   }
+};
+
+TEMPLATE_PARAMS
+void BLOCK_SEQ_LOCK_QUEUE::flush() noexcept {
+   // publish entries of a partially filled block, the next enqueue continues filling it
+   if(this->published_index != this->enqueue_index) {
+      this->enqueue_span[((this->enqueue_index - 1) / block_slots) % n_blocks].publish(this->enqueue_index);
+      this->published_index = this->enqueue_index;
+   }
+};
+
+TEMPLATE_PARAMS
+BLOCK_SEQ_LOCK_QUEUE::QueueReader::QueueReader(const BLOCK_SEQ_LOCK_QUEUE* queue_ptr_) noexcept
+    :
+    queue_ptr(queue_ptr_) {};
+
+TEMPLATE_PARAMS
+std::optional<ContentType_> BLOCK_SEQ_LOCK_QUEUE::QueueReader::read_next_entry() noexcept {
+   if(this->read_index >= this->cached_end_index) {
+      // local copy exhausted, fetch block containing read_index again
+      const auto read_result = this->queue_ptr->read_block(this->read_index, this->cached_block);
+      const std::int64_t block_begin = this->read_index - this->read_index % block_slots;
+      // block is either being filled or contains no entries that haven't been read yet
+      if(!read_result.has_value() || read_result.value() <= this->read_index) {
+         return std::nullopt;
+      }
+      // block has been overwritten by a later pass through the buffer, continue with its first entry
+      if(read_result.value() > block_begin + block_slots) {
+         this->read_index = (read_result.value() - 1) / block_slots * block_slots;
+      }
+      this->cached_end_index = read_result.value();
+   }
+   const ContentType_& ret = this->cached_block[this->read_index % block_slots];
+   ++this->read_index;
+   return ret;
+};
+
+TEMPLATE_PARAMS
+BLOCK_SEQ_LOCK_QUEUE::QueueReader BLOCK_SEQ_LOCK_QUEUE::get_reader() const noexcept {
+   return QueueReader(this);
+};
+
+#undef TEMPLATE_PARAMS
+#undef BLOCK_SEQ_LOCK_QUEUE
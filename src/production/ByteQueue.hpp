@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+
+#include "SLQ_Auxil.hpp"
+
+namespace Element {
+// cacheline-sized unit of a ByteSeqLockQueue, the payload is held in atomic words so that concurrent reads and writes
+// don't constitute a data race while copying stays cheap
+struct alignas(SLQ_Auxil::cacheline) ByteSlot {
+   static constexpr std::size_t n_words = (SLQ_Auxil::cacheline - sizeof(std::int64_t)) / sizeof(std::uint64_t);
+   static constexpr std::size_t payload_size = n_words * sizeof(std::uint64_t);
+   // 2 * position + 2 once the slot holds the complete content written at global slot position, odd while it's written
+   std::atomic<std::int64_t> version = 0;
+   std::array<std::atomic<std::uint64_t>, n_words> words{};
+};
+} // namespace Element
+
+namespace Queue {
+// single producer, multiple consumer queue for messages of varying length. every message occupies as many consecutive
+// cacheline-sized slots as it needs, the first of which starts with a length header, wrapping around the end of the
+// ring like any other slot. each slot carries its own version, derived from its global position, so that readers can
+// tell an unwritten slot from one that was overwritten by a later lap
+template<std::uint32_t length_>
+requires (std::has_single_bit(length_)) && (length_ >= 2) && std::atomic<std::int64_t>::is_always_lock_free
+struct ByteSeqLockQueue {
+private:
+   using SlotType = Element::ByteSlot;
+   static constexpr std::uint32_t length = length_;
+   static constexpr std::size_t header_size = sizeof(std::uint64_t);
+   const std::unique_ptr<SlotType[]> memory_pointer;
+   // data used by dequeueing thread
+   const std::span<SlotType, length> dequeue_span;
+   // data used by enqueueing thread
+   // global position of the slot the next message starts at, only written by the enqueueing thread, atomic so that
+   // lapped readers can resynchronize with the producer
+   alignas(SLQ_Auxil::cacheline) std::atomic<std::int64_t> enqueue_position = 0;
+   const std::span<SlotType, length> enqueue_span;
+   void write_slot(std::int64_t, std::span<const std::byte>, const std::uint64_t) noexcept;
+
+   struct QueueReader {
+   private:
+      const ByteSeqLockQueue* const queue_ptr;
+      // global position of the first slot of the next message
+      std::int64_t read_position = 0;
+      std::uint64_t overruns = 0;
+      // holds the message read last
+      const std::unique_ptr<std::byte[]> buffer;
+      bool copy_slot(std::int64_t, std::span<std::byte>, std::uint64_t* const) const noexcept;
+      void resync() noexcept;
+
+   public:
+      explicit QueueReader(const ByteSeqLockQueue*);
+      ~QueueReader() = default;
+      QueueReader(const QueueReader&) = delete;
+      QueueReader& operator=(const QueueReader&) = delete;
+      QueueReader(QueueReader&&) = delete;
+      QueueReader& operator=(QueueReader&&) = delete;
+      // the next message, valid until the next call, nullopt if there is none. a reader that has been lapped skips
+      // to the producer's current position and returns nullopt
+      std::optional<std::span<const std::byte>> read_next_entry() noexcept;
+      // number of times the reader was lapped and lost messages
+      std::uint64_t get_overruns() const noexcept;
+   };
+
+public:
+   static constexpr std::uint32_t capacity_slots = length;
+   static constexpr std::size_t slot_size = sizeof(SlotType);
+   static constexpr std::size_t footprint = slot_size * length;
+   // a message may take up to half of the ring, leaving readers time to copy it before it gets overwritten
+   static constexpr std::size_t max_message_size = length / 2 * SlotType::payload_size - header_size;
+   // slots occupied by a message of the given size
+   static constexpr std::uint32_t slots_for(const std::size_t message_size) noexcept {
+      return static_cast<std::uint32_t>((header_size + message_size + SlotType::payload_size - 1) / SlotType::payload_size);
+   };
+   explicit ByteSeqLockQueue();
+   ~ByteSeqLockQueue() = default;
+   ByteSeqLockQueue(const ByteSeqLockQueue&) = delete;
+   ByteSeqLockQueue& operator=(const ByteSeqLockQueue&) = delete;
+   ByteSeqLockQueue(ByteSeqLockQueue&&) = delete;
+   ByteSeqLockQueue& operator=(ByteSeqLockQueue&&) = delete;
+   using ReaderType = QueueReader;
+   // returns false without enqueueing anything if the message exceeds max_message_size
+   bool enqueue(std::span<const std::byte>) noexcept;
+   QueueReader get_reader() const;
+};
+} // namespace Queue
+
+#define TEMPLATE_PARAMS             \
+   template<std::uint32_t length_> \
+   requires (std::has_single_bit(length_)) && (length_ >= 2) && std::atomic<std::int64_t>::is_always_lock_free
+
+#define BYTE_SEQ_LOCK_QUEUE \
+   Queue::ByteSeqLockQueue<length_>
+
+TEMPLATE_PARAMS
+BYTE_SEQ_LOCK_QUEUE::ByteSeqLockQueue():
+    memory_pointer{new(std::align_val_t{SLQ_Auxil::cacheline}) SlotType[length]()},
+    dequeue_span{this->memory_pointer.get(), length},
+    enqueue_span{this->memory_pointer.get(), length} {};
+
+TEMPLATE_PARAMS
+void BYTE_SEQ_LOCK_QUEUE::write_slot(std::int64_t position, std::span<const std::byte> bytes, const std::uint64_t header) noexcept {
+   // header != 0 marks the first slot of a message, its first word holds the message's length
+   std::array<std::uint64_t, SlotType::n_words> words{};
+   const std::size_t offset = header != 0 ? header_size : 0;
+   words[0] = header;
+   std::memcpy(reinterpret_cast<std::byte*>(words.data()) + offset, bytes.data(), bytes.size());
+   const std::size_t n_words = (offset + bytes.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+   SlotType& slot = this->enqueue_span[position % length];
+   slot.version.store(2 * position + 1, std::memory_order_relaxed);
+   // odd version needs to be visible before any part of the new content
+   SLQ_Auxil::store_fence();
+   for(std::size_t w = 0; w < n_words; ++w) {
+      slot.words[w].store(words[w], std::memory_order_relaxed);
+   }
+   slot.version.store(2 * position + 2, std::memory_order_release);
+};
+
+TEMPLATE_PARAMS
+bool BYTE_SEQ_LOCK_QUEUE::enqueue(std::span<const std::byte> message) noexcept {
+   if(message.size() > max_message_size) {
+      return false;
+   }
+   const std::int64_t start = this->enqueue_position.load(std::memory_order_relaxed);
+   const std::uint32_t n_slots = slots_for(message.size());
+   const std::size_t first_slot_bytes = std::min(message.size(), SlotType::payload_size - header_size);
+   // the first slot is written last, readers that find it complete know that the rest of the message is as well
+   for(std::uint32_t s = 1; s < n_slots; ++s) {
+      const std::size_t offset = first_slot_bytes + (s - 1) * SlotType::payload_size;
+      this->write_slot(start + s, message.subspan(offset, std::min(SlotType::payload_size, message.size() - offset)), 0);
+   }
+   // the length header is offset by one so that it is non-zero for empty messages as well
+   this->write_slot(start, message.first(first_slot_bytes), message.size() + 1);
+   this->enqueue_position.store(start + n_slots, std::memory_order_relaxed);
+   return true;
+};
+
+TEMPLATE_PARAMS
+BYTE_SEQ_LOCK_QUEUE::QueueReader BYTE_SEQ_LOCK_QUEUE::get_reader() const {
+   return QueueReader(this);
+};
+
+TEMPLATE_PARAMS
+BYTE_SEQ_LOCK_QUEUE::QueueReader::QueueReader(const BYTE_SEQ_LOCK_QUEUE* queue_ptr_)
+    :
+    queue_ptr(queue_ptr_),
+    buffer(new std::byte[length / 2 * SlotType::payload_size]) {};
+
+TEMPLATE_PARAMS
+bool BYTE_SEQ_LOCK_QUEUE::QueueReader::copy_slot(std::int64_t position, std::span<std::byte> dest, std::uint64_t* const header) const noexcept {
+   // copies the slot at position if it holds the content written at position, the first word goes to header if it
+   // isn't nullptr
+   const SlotType& slot = this->queue_ptr->dequeue_span[position % length];
+   const std::int64_t expected_version = 2 * position + 2;
+   if(slot.version.load(std::memory_order_acquire) != expected_version) {
+      return false;
+   }
+   std::array<std::uint64_t, SlotType::n_words> words;
+   const std::size_t offset = header != nullptr ? header_size : 0;
+   const std::size_t n_words = (offset + dest.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+   for(std::size_t w = 0; w < n_words; ++w) {
+      words[w] = slot.words[w].load(std::memory_order_relaxed);
+   }
+   // content needs to be read completely before the version is checked again
+   SLQ_Auxil::load_fence();
+   if(slot.version.load(std::memory_order_relaxed) != expected_version) {
+      return false;
+   }
+   if(header != nullptr) {
+      *header = words[0];
+   }
+   std::memcpy(dest.data(), reinterpret_cast<const std::byte*>(words.data()) + offset, dest.size());
+   return true;
+};
+
+TEMPLATE_PARAMS
+void BYTE_SEQ_LOCK_QUEUE::QueueReader::resync() noexcept {
+   // message boundaries of the slots that haven't been overwritten yet are unknown, the reader continues with the next
+   // message the producer is going to write
+   ++this->overruns;
+   this->read_position = this->queue_ptr->enqueue_position.load(std::memory_order_relaxed);
+};
+
+TEMPLATE_PARAMS
+std::optional<std::span<const std::byte>> BYTE_SEQ_LOCK_QUEUE::QueueReader::read_next_entry() noexcept {
+   const SlotType& first_slot = this->queue_ptr->dequeue_span[this->read_position % length];
+   const std::int64_t expected_version = 2 * this->read_position + 2;
+   const std::int64_t found_version = first_slot.version.load(std::memory_order_acquire);
+   // slot not written in this lap yet, or its write is still in progress
+   if(found_version < expected_version) {
+      return std::nullopt;
+   }
+   std::uint64_t header = 0;
+   const std::size_t first_slot_capacity = SlotType::payload_size - header_size;
+   std::byte* const dest = this->buffer.get();
+   if(found_version > expected_version || !this->copy_slot(this->read_position, std::span(dest, first_slot_capacity), &header)) {
+      this->resync();
+      return std::nullopt;
+   }
+   const std::size_t message_size = header - 1;
+   const std::uint32_t n_slots = slots_for(message_size);
+   // remaining slots were completed before the first one, they can only fail to match if they were overwritten since
+   for(std::uint32_t s = 1; s < n_slots; ++s) {
+      const std::size_t offset = first_slot_capacity + (s - 1) * SlotType::payload_size;
+      if(!this->copy_slot(this->read_position + s, std::span(dest + offset, std::min(SlotType::payload_size, message_size - offset)), nullptr)) {
+         this->resync();
+         return std::nullopt;
+      }
+   }
+   this->read_position += n_slots;
+   return std::span<const std::byte>(dest, message_size);
+};
+
+TEMPLATE_PARAMS
+std::uint64_t BYTE_SEQ_LOCK_QUEUE::QueueReader::get_overruns() const noexcept {
+   return this->overruns;
+};
+
+#undef TEMPLATE_PARAMS
+#undef BYTE_SEQ_LOCK_QUEUE
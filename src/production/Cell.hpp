@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+#include "Element.hpp"
+#include "SLQ_Auxil.hpp"
+
+namespace Cell {
+// latest value of T published by a single writer to any number of readers, e.g. configuration or reference prices.
+// the value is held in a queue element, copied by the same engines (byte wise atomic unless accept_UB, chunked for
+// large payloads) and, if double_buffer is set, written alternately to two copies so that readers never wait
+template<typename T, bool accept_UB, bool double_buffer = false>
+requires std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+struct SeqLockCell {
+private:
+   using ContentType = SLQ_Auxil::UB_or_not_UB<T, accept_UB>;
+   using UnalignedElement = std::conditional_t<double_buffer, Element::DoubleBufferedElement<ContentType, 0>, Element::SeqLockElement<ContentType, 0>>;
+   // on cachelines of its own, readers polling the cell don't interfere with neighbouring data
+   static constexpr std::size_t alignment = SLQ_Auxil::ceil_(alignof(UnalignedElement), SLQ_Auxil::cacheline);
+   using ElementType = std::conditional_t<double_buffer, Element::DoubleBufferedElement<ContentType, alignment>,
+      Element::SeqLockElement<ContentType, alignment>>;
+   ElementType element;
+
+public:
+   using ValueType = T;
+   // version of a cell nothing has been stored to yet
+   static constexpr std::int64_t initial_version = 0;
+   static constexpr std::size_t footprint = sizeof(ElementType);
+   explicit SeqLockCell() noexcept = default;
+   ~SeqLockCell() = default;
+   SeqLockCell(const SeqLockCell&) = delete;
+   SeqLockCell& operator=(const SeqLockCell&) = delete;
+   SeqLockCell(SeqLockCell&&) = delete;
+   SeqLockCell& operator=(SeqLockCell&&) = delete;
+   // only ever to be called by one thread at a time
+   void store(const T&) noexcept;
+   // current value, default constructed if nothing has been stored yet
+   T load() const noexcept;
+   // current value if it has been stored after the one last_version refers to, last_version is then updated to the
+   // value's version. pass initial_version to get the first value stored
+   std::optional<T> load_if_changed(std::int64_t&) const noexcept;
+   // increases with every store, even unless a store is in progress
+   std::int64_t version() const noexcept;
+};
+} // namespace Cell
+
+#define TEMPLATE_PARAMS                                            \
+   template<typename T, bool accept_UB, bool double_buffer>       \
+   requires std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+
+#define SEQ_LOCK_CELL Cell::SeqLockCell<T, accept_UB, double_buffer>
+
+TEMPLATE_PARAMS
+void SEQ_LOCK_CELL::store(const T& value) noexcept {
+   this->element.insert(value);
+};
+
+TEMPLATE_PARAMS
+T SEQ_LOCK_CELL::load() const noexcept {
+   // reading with version 0 always returns the content
+   return std::get<0>(this->element.read(0)).value();
+};
+
+TEMPLATE_PARAMS
+std::optional<T> SEQ_LOCK_CELL::load_if_changed(std::int64_t& last_version) const noexcept {
+   // completed versions are even, any later store results in a version of at least last_version + 2
+   if(this->element.version.load(std::memory_order_relaxed) < last_version + 2) {
+      return std::nullopt;
+   }
+   const auto [value, read_version] = this->element.read(last_version + 1);
+   if(value.has_value()) {
+      last_version = read_version;
+   }
+   return value;
+};
+
+TEMPLATE_PARAMS
+std::int64_t SEQ_LOCK_CELL::version() const noexcept {
+   return this->element.version.load(std::memory_order_acquire);
+};
+
+#undef TEMPLATE_PARAMS
+#undef SEQ_LOCK_CELL
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+#include "LastValueCache.hpp"
+#include "Queue.hpp"
+#include "SLQ_Auxil.hpp"
+
+namespace Queue {
+// single producer queue of updates to keys 0 to n_keys - 1 that conflates updates a reader hasn't caught up with yet.
+// the latest value of every key is held in a seqlock element of its own as in a LastValueCache, every reader has a ring of keys and a pending
+// bit per key: a store enqueues its key into a reader's ring only if the key isn't pending for that reader already. a
+// slow reader's backlog is thus bounded by the number of distinct keys rather than by the rate of updates, and it
+// reads the latest value of a key however often the key was stored in the meantime
+template<typename T, std::uint32_t n_keys_, std::uint32_t max_readers, bool accept_UB>
+requires (n_keys_ > 0) && (max_readers > 0) && std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+struct ConflatingQueue {
+private:
+   static constexpr std::uint32_t n_keys = n_keys_;
+   using ElementsType = Cache::KeyedElements<T, n_keys, accept_UB>;
+   static constexpr std::uint32_t n_words = (n_keys + 63) / 64;
+   // a key is in a reader's ring at most once unless the reader attached while the key was being stored, which may
+   // leave one more entry for it. the ring is never lapped and no pending key is lost
+   using KeyQueueType = SeqLockQueue<std::uint32_t, std::bit_ceil(n_keys + 1), true, false>;
+
+   struct ReaderSlot {
+      alignas(SLQ_Auxil::cacheline) std::array<std::atomic<std::uint64_t>, n_words> pending{};
+      // set while a reader is attached, keys are only enqueued for attached readers
+      alignas(SLQ_Auxil::cacheline) std::atomic<bool> active = false;
+      std::atomic<bool> claimed = false;
+      KeyQueueType keys;
+   };
+
+   ElementsType elements;
+   const std::unique_ptr<std::array<ReaderSlot, max_readers>> reader_slots;
+
+   struct Update {
+      std::uint32_t key;
+      T value;
+   };
+
+   struct QueueReader {
+   private:
+      const ConflatingQueue* const queue_ptr;
+      // nullptr if max_readers readers exist already
+      ReaderSlot* const slot;
+      typename KeyQueueType::ReaderType key_reader;
+
+   public:
+      explicit QueueReader(const ConflatingQueue*, ReaderSlot*) noexcept;
+      ~QueueReader();
+      QueueReader(const QueueReader&) = delete;
+      QueueReader& operator=(const QueueReader&) = delete;
+      QueueReader(QueueReader&&) = delete;
+      QueueReader& operator=(QueueReader&&) = delete;
+      // latest value of the next key stored since the reader last read it, nullopt if there is none. keys are
+      // returned in the order in which they first became pending
+      std::optional<Update> read_next_entry() noexcept;
+      bool is_attached() const noexcept;
+   };
+
+public:
+   using ValueType = T;
+   using UpdateType = Update;
+   static constexpr std::uint32_t capacity = n_keys;
+   static constexpr std::size_t element_size = ElementsType::element_size;
+   // number of entries a reader's ring of keys holds
+   static constexpr std::uint32_t key_ring_length = KeyQueueType::capacity;
+   explicit ConflatingQueue();
+   ~ConflatingQueue() = default;
+   ConflatingQueue(const ConflatingQueue&) = delete;
+   ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+   ConflatingQueue(ConflatingQueue&&) = delete;
+   ConflatingQueue& operator=(ConflatingQueue&&) = delete;
+   using ReaderType = QueueReader;
+   // key needs to be smaller than capacity, only ever to be called by one thread at a time
+   void enqueue(const std::uint32_t, const T&) noexcept;
+   // latest value of key, default constructed if it hasn't been stored yet
+   T load(const std::uint32_t) const noexcept;
+   // reader with a ring of keys of its own, detached (is_attached() returns false, read_next_entry always returns
+   // nullopt) if max_readers readers exist already. a reader only sees keys stored after it attached, one needing
+   // every value loads all keys once after attaching
+   QueueReader get_reader() const noexcept;
+};
+} // namespace Queue
+
+#define TEMPLATE_PARAMS                                                                            \
+   template<typename T, std::uint32_t n_keys_, std::uint32_t max_readers, bool accept_UB>          \
+   requires (n_keys_ > 0) && (max_readers > 0) && std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+
+#define CONFLATING_QUEUE Queue::ConflatingQueue<T, n_keys_, max_readers, accept_UB>
+
+TEMPLATE_PARAMS
+CONFLATING_QUEUE::ConflatingQueue():
+    reader_slots{new std::array<ReaderSlot, max_readers>()} {};
+
+TEMPLATE_PARAMS
+void CONFLATING_QUEUE::enqueue(const std::uint32_t key, const T& value) noexcept {
+   this->elements.store(key, value);
+   const std::uint64_t bit = std::uint64_t{1} << (key % 64);
+   for(ReaderSlot& slot : *this->reader_slots) {
+      if(!slot.active.load(std::memory_order_acquire)) {
+         continue;
+      }
+      // a key that is pending already is read by the reader after this store, it only clears the bit right before
+      // loading the value
+      if((slot.pending[key / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) == 0) {
+         slot.keys.enqueue(key);
+      }
+   }
+};
+
+TEMPLATE_PARAMS
+T CONFLATING_QUEUE::load(const std::uint32_t key) const noexcept {
+   return this->elements.load(key);
+};
+
+TEMPLATE_PARAMS
+CONFLATING_QUEUE::QueueReader CONFLATING_QUEUE::get_reader() const noexcept {
+   return QueueReader(this, Cache::claim_slot(*this->reader_slots));
+};
+
+TEMPLATE_PARAMS
+CONFLATING_QUEUE::QueueReader::QueueReader(const CONFLATING_QUEUE* queue_ptr_, ReaderSlot* slot_) noexcept
+    :
+    queue_ptr(queue_ptr_),
+    slot(slot_),
+    // a previous reader's keys are skipped, the ring of a detached reader is never written to
+    key_reader(slot_ != nullptr ? slot_->keys.get_reader_at_producer() : queue_ptr_->reader_slots->front().keys.get_reader_at_producer()) {
+   if(slot_ == nullptr) {
+      return;
+   }
+   // bits are cleared after the reader's start position was taken: a store setting a bit after it has been cleared
+   // enqueues its key behind that position, one setting it before leaves no pending bit behind
+   for(std::atomic<std::uint64_t>& word : slot_->pending) {
+      word.store(0, std::memory_order_release);
+   }
+   slot_->active.store(true, std::memory_order_release);
+};
+
+TEMPLATE_PARAMS
+CONFLATING_QUEUE::QueueReader::~QueueReader() {
+   if(this->slot != nullptr) {
+      this->slot->active.store(false, std::memory_order_relaxed);
+      this->slot->claimed.store(false, std::memory_order_release);
+   }
+};
+
+TEMPLATE_PARAMS
+std::optional<typename CONFLATING_QUEUE::Update> CONFLATING_QUEUE::QueueReader::read_next_entry() noexcept {
+   if(this->slot == nullptr) {
+      return std::nullopt;
+   }
+   const std::optional<std::uint32_t> key = this->key_reader.read_next_entry();
+   if(!key.has_value()) {
+      return std::nullopt;
+   }
+   // bit is cleared before the value is loaded, a store after the load enqueues the key again. a store whose bit was
+   // cleared here is synchronized with, the value loaded is the one it stored or a later one
+   this->slot->pending[key.value() / 64].fetch_and(~(std::uint64_t{1} << (key.value() % 64)), std::memory_order_acq_rel);
+   return Update{key.value(), this->queue_ptr->load(key.value())};
+};
+
+TEMPLATE_PARAMS
+bool CONFLATING_QUEUE::QueueReader::is_attached() const noexcept {
+   return this->slot != nullptr;
+};
+
+#undef TEMPLATE_PARAMS
+#undef CONFLATING_QUEUE
@@ -1,21 +1,37 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <optional>
 #include <tuple>
 
 #include "SLQ_Auxil.hpp"
+#include "Stats.hpp"
+#include "Tracing.hpp"
 
 namespace Element {
-template<typename ContentType, std::uint32_t alignment>
+// large payloads are read chunk by chunk so that a read overlapping with a write can be aborted early
+template<typename ContentType, std::uint32_t alignment, bool chunked_read_ = (sizeof(ContentType) > SLQ_Auxil::chunked_read_threshold)>
 struct alignas(alignment) SeqLockElement {
+private:
+   bool copy_content(ContentType&, const std::int64_t) const noexcept;
+
+public:
    using PayloadType = ContentType::type;
+   static constexpr bool chunked_read = chunked_read_;
    ContentType content;
    std::atomic<std::int64_t> version = 0;
    void insert(const PayloadType&) noexcept;
+   // counts retries and spin iterations in a Stats::ReaderStats, the default counts nothing
+   template<typename StatsType = Stats::ReaderStats<false>>
+   std::tuple<std::optional<PayloadType>, std::int64_t>
+      read(const std::int64_t, StatsType&& = StatsType{}) const noexcept;
+   // same as read(prev_version), but gives up after max_attempts attempts found a write in progress or tore the copy
+   // and returns nullopt. for readers that can't rely on the writer to finish, e.g. in another process that may die
    std::tuple<std::optional<PayloadType>, std::int64_t>
-      read(const std::int64_t) const noexcept;
+      try_read(const std::int64_t, const std::uint64_t) const noexcept;
    explicit SeqLockElement() noexcept = default;
    ~SeqLockElement() = default;
    SeqLockElement(const SeqLockElement&) = delete;
@@ -24,40 +40,140 @@ struct alignas(alignment) SeqLockElement {
    SeqLockElement(SeqLockElement&&) = delete;
    SeqLockElement& operator=(SeqLockElement&&) = delete;
 };
+
+// holds two copies of the content that are written alternately, reads always use the last completely written copy
+// and therefore never have to wait for a write in progress to complete
+template<typename ContentType, std::uint32_t alignment>
+struct alignas(alignment) DoubleBufferedElement {
+   using PayloadType = ContentType::type;
+   std::array<ContentType, 2> content;
+   std::atomic<std::int64_t> version = 0;
+   void insert(const PayloadType&) noexcept;
+   // counts retries in a Stats::ReaderStats, the default counts nothing
+   template<typename StatsType = Stats::ReaderStats<false>>
+   std::tuple<std::optional<PayloadType>, std::int64_t>
+      read(const std::int64_t, StatsType&& = StatsType{}) const noexcept;
+   explicit DoubleBufferedElement() noexcept = default;
+   ~DoubleBufferedElement() = default;
+   DoubleBufferedElement(const DoubleBufferedElement&) = delete;
+   // copy assigment operator needs to be defined
+   DoubleBufferedElement& operator=(const DoubleBufferedElement&) noexcept;
+   DoubleBufferedElement(DoubleBufferedElement&&) = delete;
+   DoubleBufferedElement& operator=(DoubleBufferedElement&&) = delete;
+};
+
+// a single version guards a whole block of slots, it is only bumped when the block is opened for a new pass of the
+// producer and when its first entries are published. entries published later on during the same pass only advance
+// end_index, entries below it stay readable while the producer fills the rest of the block. readers validate and copy
+// the entire block at once
+template<typename ContentType, std::uint32_t slots_>
+struct alignas(SLQ_Auxil::cacheline) SeqLockBlock {
+   using PayloadType = ContentType::type;
+   using BlockContentType = std::array<ContentType, slots_>;
+   static constexpr std::uint32_t slots = slots_;
+   std::atomic<std::int64_t> version = 0;
+   // global queue index one past the last entry published in this block
+   std::atomic<std::int64_t> end_index = 0;
+   BlockContentType content;
+   void open() noexcept;
+   void insert(const std::uint32_t, const PayloadType&) noexcept;
+   void publish(const std::int64_t) noexcept;
+   std::optional<std::int64_t> read(BlockContentType&) const noexcept;
+   explicit SeqLockBlock() noexcept = default;
+   ~SeqLockBlock() = default;
+   SeqLockBlock(const SeqLockBlock&) = delete;
+   SeqLockBlock& operator=(const SeqLockBlock&) = delete;
+   SeqLockBlock(SeqLockBlock&&) = delete;
+   SeqLockBlock& operator=(SeqLockBlock&&) = delete;
+};
 };
 
 #define TEMPLATE_PARAMS \
-   template<typename ContentType, std::uint32_t alignment>
+   template<typename ContentType, std::uint32_t alignment, bool chunked_read_>
 
-#define SEQ_LOCK_ELEMENT Element::SeqLockElement<ContentType, alignment>
+#define SEQ_LOCK_ELEMENT Element::SeqLockElement<ContentType, alignment, chunked_read_>
 
 TEMPLATE_PARAMS
 void SEQ_LOCK_ELEMENT::insert(const PayloadType& new_content) noexcept {
-   this->version.fetch_add(1, std::memory_order_acquire);
+   // only a single thread ever writes to an element, the version can thus be bumped without read-modify-write instructions
+   const std::int64_t initial_version = this->version.load(std::memory_order_relaxed);
+   this->version.store(initial_version + 1, std::memory_order_relaxed);
+   // odd version needs to be visible before any part of the new content
+   SLQ_Auxil::store_fence();
    this->content = ContentType(new_content);
-   this->version.fetch_add(1, std::memory_order_release);
+   // even version is published only after all of the new content
+   this->version.store(initial_version + 2, std::memory_order_release);
 };
 
 TEMPLATE_PARAMS
+bool SEQ_LOCK_ELEMENT::copy_content(ContentType& dest, const std::int64_t initial_version) const noexcept {
+   if constexpr(chunked_read) {
+      // check version after every chunk, a torn copy is abandoned as soon as a write is detected
+      for(size_t offset = 0; offset < sizeof(ContentType); offset += SLQ_Auxil::chunk_size) {
+         dest.copy_chunk(this->content, offset, std::min(SLQ_Auxil::chunk_size, sizeof(ContentType) - offset));
+         SLQ_Auxil::load_fence();
+         if(this->version.load(std::memory_order_relaxed) != initial_version) {
+            return false;
+         }
+      }
+      return true;
+   }
+   else {
+      // atomic byte wise copying if accept_UB == false
+      dest = this->content;
+      // content needs to be read completely before the version is checked again
+      SLQ_Auxil::load_fence();
+      return this->version.load(std::memory_order_relaxed) == initial_version;
+   }
+};
+
+TEMPLATE_PARAMS
+template<typename StatsType>
 std::tuple<std::optional<typename SEQ_LOCK_ELEMENT::PayloadType>, std::int64_t>
-   SEQ_LOCK_ELEMENT::read(const std::int64_t prev_version) const noexcept {
+   SEQ_LOCK_ELEMENT::read(const std::int64_t prev_version, StatsType&& stats) const noexcept {
    // first element of ret will be implicitly converted to std::optional<PayloadType> when returned
    std::tuple<std::optional<ContentType>, std::int64_t> ret;
    std::optional<ContentType>& ret_opt = std::get<0>(ret);
    std::int64_t& initial_version = std::get<1>(ret);
-   std::atomic<std::int64_t> final_version;
-   do {
+   ret_opt.emplace();
+   while(true) {
       initial_version = this->version.load(std::memory_order_acquire);
-      // atomic byte wise copying if accept_UB == false
-      ret_opt = this->content;
-      final_version.store(this->version, std::memory_order_release);
-      // spin if write took place while reading
+      // spin without copying while a write is in progress, spin again if a write took place while reading. counting
+      // compiles to nothing with the default stats type
+      if(initial_version % 2 != 0) {
+         stats.spin();
+         SLQ_TRACEPOINT1(element_retry, initial_version);
+         continue;
+      }
+      if(this->copy_content(ret_opt.value(), initial_version)) {
+         break;
+      }
+      stats.retry();
+      SLQ_TRACEPOINT1(element_retry, initial_version);
    }
-   while(initial_version % 2 || (initial_version != final_version));
    ret_opt = initial_version >= prev_version ? ret_opt : std::nullopt;
    return ret;
 };
 
+TEMPLATE_PARAMS
+std::tuple<std::optional<typename SEQ_LOCK_ELEMENT::PayloadType>, std::int64_t>
+   SEQ_LOCK_ELEMENT::try_read(const std::int64_t prev_version, const std::uint64_t max_attempts) const noexcept {
+   std::tuple<std::optional<ContentType>, std::int64_t> ret;
+   std::optional<ContentType>& ret_opt = std::get<0>(ret);
+   std::int64_t& initial_version = std::get<1>(ret);
+   ret_opt.emplace();
+   for(std::uint64_t attempt = 0; attempt < max_attempts; ++attempt) {
+      initial_version = this->version.load(std::memory_order_acquire);
+      if(initial_version % 2 == 0 && this->copy_content(ret_opt.value(), initial_version)) {
+         ret_opt = initial_version >= prev_version ? ret_opt : std::nullopt;
+         return ret;
+      }
+      SLQ_TRACEPOINT1(element_retry, initial_version);
+   }
+   ret_opt = std::nullopt;
+   return ret;
+};
+
 TEMPLATE_PARAMS
 SEQ_LOCK_ELEMENT& SEQ_LOCK_ELEMENT::operator=(const SEQ_LOCK_ELEMENT& other) noexcept {
    // read() provides functionality to safely retrieve content and version
@@ -70,3 +186,109 @@ SEQ_LOCK_ELEMENT& SEQ_LOCK_ELEMENT::operator=(const SEQ_LOCK_ELEMENT& other) noe
 
 #undef TEMPLATE_PARAMS
 #undef SEQ_LOCK_ELEMENT
+
+#define TEMPLATE_PARAMS \
+   template<typename ContentType, std::uint32_t alignment>
+
+#define DOUBLE_BUFFERED_ELEMENT Element::DoubleBufferedElement<ContentType, alignment>
+
+TEMPLATE_PARAMS
+void DOUBLE_BUFFERED_ELEMENT::insert(const PayloadType& new_content) noexcept {
+   const std::int64_t initial_version = this->version.load(std::memory_order_relaxed);
+   // readers acquiring the odd version read the copy completed by the previous write, the store needs to release it
+   // as well since only the even version stored by that write released it so far
+   this->version.store(initial_version + 1, std::memory_order_release);
+   SLQ_Auxil::store_fence();
+   // n-th write goes to copy n % 2, the copy holding the result of the previous write is left untouched
+   this->content[(initial_version / 2 + 1) % 2] = ContentType(new_content);
+   this->version.store(initial_version + 2, std::memory_order_release);
+};
+
+TEMPLATE_PARAMS
+template<typename StatsType>
+std::tuple<std::optional<typename DOUBLE_BUFFERED_ELEMENT::PayloadType>, std::int64_t>
+   DOUBLE_BUFFERED_ELEMENT::read(const std::int64_t prev_version, StatsType&& stats) const noexcept {
+   // first element of ret will be implicitly converted to std::optional<PayloadType> when returned
+   std::tuple<std::optional<ContentType>, std::int64_t> ret;
+   std::optional<ContentType>& ret_opt = std::get<0>(ret);
+   std::int64_t& completed_version = std::get<1>(ret);
+   std::int64_t final_version;
+   while(true) {
+      // version of the last completed write, an odd version only indicates a write to the other copy
+      completed_version = this->version.load(std::memory_order_acquire) & ~std::int64_t{1};
+      ret_opt = this->content[(completed_version / 2) % 2];
+      SLQ_Auxil::load_fence();
+      final_version = this->version.load(std::memory_order_relaxed);
+      // copy can only have been torn if the write after the one in progress during the read has started as well
+      if(final_version - completed_version <= 2) {
+         break;
+      }
+      stats.retry();
+   }
+   ret_opt = completed_version >= prev_version ? ret_opt : std::nullopt;
+   return ret;
+};
+
+TEMPLATE_PARAMS
+DOUBLE_BUFFERED_ELEMENT& DOUBLE_BUFFERED_ELEMENT::operator=(const DOUBLE_BUFFERED_ELEMENT& other) noexcept {
+   const auto read_ret = other.read(0);
+   const std::int64_t read_version = std::get<1>(read_ret);
+   this->content[(read_version / 2) % 2] = ContentType(std::get<0>(read_ret).value());
+   this->version.store(read_version, std::memory_order_relaxed);
+   return *this;
+};
+
+#undef TEMPLATE_PARAMS
+#undef DOUBLE_BUFFERED_ELEMENT
+
+#define TEMPLATE_PARAMS \
+   template<typename ContentType, std::uint32_t slots_>
+
+#define SEQ_LOCK_BLOCK Element::SeqLockBlock<ContentType, slots_>
+
+TEMPLATE_PARAMS
+void SEQ_LOCK_BLOCK::open() noexcept {
+   const std::int64_t initial_version = this->version.load(std::memory_order_relaxed);
+   this->version.store(initial_version + 1, std::memory_order_relaxed);
+   SLQ_Auxil::store_fence();
+};
+
+TEMPLATE_PARAMS
+void SEQ_LOCK_BLOCK::insert(const std::uint32_t slot, const PayloadType& new_content) noexcept {
+   // block needs to be open, slots at or above end_index are ignored by readers until they are published
+   this->content[slot] = ContentType(new_content);
+};
+
+TEMPLATE_PARAMS
+void SEQ_LOCK_BLOCK::publish(const std::int64_t new_end_index) noexcept {
+   // entries below the new end index are complete before it becomes visible
+   this->end_index.store(new_end_index, std::memory_order_release);
+   const std::int64_t current_version = this->version.load(std::memory_order_relaxed);
+   // only the first publication of a pass completes the version, later ones leave it even
+   if(current_version % 2) {
+      this->version.store(current_version + 1, std::memory_order_release);
+   }
+};
+
+TEMPLATE_PARAMS
+std::optional<std::int64_t> SEQ_LOCK_BLOCK::read(BlockContentType& dest) const noexcept {
+   while(true) {
+      const std::int64_t initial_version = this->version.load(std::memory_order_acquire);
+      // block is being filled, none of its entries can be read until they are published
+      if(initial_version % 2) {
+         return std::nullopt;
+      }
+      // end_index may advance without a version change, the entries below it are only visible through its own release
+      const std::int64_t read_end_index = this->end_index.load(std::memory_order_acquire);
+      dest = this->content;
+      SLQ_Auxil::load_fence();
+      // spin if block was opened for the producer's next pass while reading, entries at or above read_end_index may
+      // have been written in the meantime but are not returned
+      if(this->version.load(std::memory_order_relaxed) == initial_version) {
+         return read_end_index;
+      }
+   }
+};
+
+#undef TEMPLATE_PARAMS
+#undef SEQ_LOCK_BLOCK
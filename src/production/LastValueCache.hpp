@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+#include "Element.hpp"
+#include "SLQ_Auxil.hpp"
+
+namespace Cache {
+// two level bitmap of keys changed since a reader last looked: a bit per key, grouped in 64 bit words, and a summary bit
+// per word that is set whenever any of the word's bits is. the summary is on cachelines of its own, a scan reads it and
+// then only the words it marks
+template<std::uint32_t n_keys>
+struct DirtyBitmap {
+   static constexpr std::uint32_t n_words = (n_keys + 63) / 64;
+   static constexpr std::uint32_t n_summary_words = (n_words + 63) / 64;
+   alignas(SLQ_Auxil::cacheline) std::array<std::atomic<std::uint64_t>, n_words> words{};
+   alignas(SLQ_Auxil::cacheline) std::array<std::atomic<std::uint64_t>, n_summary_words> summary{};
+   // set while a reader is attached, only the bitmaps of attached readers are marked
+   alignas(SLQ_Auxil::cacheline) std::atomic<bool> active = false;
+   std::atomic<bool> claimed = false;
+
+   // key's bit is set before the summary bit, a reader clears them in the opposite order, so a key marked while a
+   // scan is in progress is either seen by that scan or by the next one. a word that already had bits set is either
+   // marked in the summary or about to be drained by a scan in progress, its summary bit is left alone
+   void mark(const std::uint32_t key) noexcept {
+      const std::uint32_t word = key / 64;
+      if(this->words[word].fetch_or(std::uint64_t{1} << (key % 64), std::memory_order_release) == 0) {
+         this->summary[word / 64].fetch_or(std::uint64_t{1} << (word % 64), std::memory_order_release);
+      }
+   };
+
+   void clear() noexcept {
+      for(std::atomic<std::uint64_t>& summary_word : this->summary) {
+         summary_word.store(0, std::memory_order_relaxed);
+      }
+      for(std::atomic<std::uint64_t>& word : this->words) {
+         word.store(0, std::memory_order_relaxed);
+      }
+   };
+
+   // calls f with every marked key in ascending order and unmarks it, returns the number of keys
+   template<typename F>
+   std::uint32_t drain(F&& f) noexcept {
+      std::uint32_t n_drained = 0;
+      for(std::uint32_t s = 0; s < n_summary_words; ++s) {
+         if(this->summary[s].load(std::memory_order_relaxed) == 0) {
+            continue;
+         }
+         for(std::uint64_t marked_words = this->summary[s].exchange(0, std::memory_order_acquire); marked_words != 0; marked_words &= marked_words - 1) {
+            const std::uint32_t word = s * 64 + std::countr_zero(marked_words);
+            for(std::uint64_t marked_keys = this->words[word].exchange(0, std::memory_order_acquire); marked_keys != 0; marked_keys &= marked_keys - 1) {
+               f(word * 64 + static_cast<std::uint32_t>(std::countr_zero(marked_keys)));
+               ++n_drained;
+            }
+         }
+      }
+      return n_drained;
+   };
+};
+
+// latest value per key for keys 0 to n_keys - 1 in packed seqlock elements indexed by key, written by a single writer.
+// elements share cachelines like those of a SeqLockQueue with share_cacheline == true
+template<typename T, std::uint32_t n_keys, bool accept_UB>
+requires (n_keys > 0) && std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+struct KeyedElements {
+private:
+   template<std::uint32_t alignment>
+   using ElementTemplate = Element::SeqLockElement<SLQ_Auxil::UB_or_not_UB<T, accept_UB>, alignment>;
+   static constexpr std::size_t element_alignment = SLQ_Auxil::divisible_or_ceil(alignof(ElementTemplate<0>), SLQ_Auxil::cacheline);
+   static constexpr std::size_t memory_alignment = std::max(SLQ_Auxil::cacheline, element_alignment);
+   using ElementType = ElementTemplate<element_alignment>;
+   const std::unique_ptr<ElementType[]> memory_pointer;
+   const std::span<ElementType, n_keys> elements;
+
+public:
+   static constexpr std::size_t element_size = sizeof(ElementType);
+   explicit KeyedElements():
+       memory_pointer{new(std::align_val_t{memory_alignment}) ElementType[n_keys]()},
+       elements{this->memory_pointer.get(), n_keys} {};
+   ~KeyedElements() = default;
+   KeyedElements(const KeyedElements&) = delete;
+   KeyedElements& operator=(const KeyedElements&) = delete;
+   KeyedElements(KeyedElements&&) = delete;
+   KeyedElements& operator=(KeyedElements&&) = delete;
+
+   // key needs to be smaller than n_keys
+   void store(const std::uint32_t key, const T& value) noexcept {
+      this->elements[key].insert(value);
+   };
+
+   // latest value of key, default constructed if it hasn't been stored yet
+   T load(const std::uint32_t key) const noexcept {
+      // reading with version 0 always returns the content
+      return std::get<0>(this->elements[key].read(0)).value();
+   };
+};
+
+// first of slots whose claimed flag could be set by this call, nullptr if all of them are claimed already. the slot is
+// released by storing false to its claimed flag
+template<typename SlotType, std::size_t n_slots>
+SlotType* claim_slot(std::array<SlotType, n_slots>& slots) noexcept {
+   for(SlotType& slot : slots) {
+      bool expected = false;
+      if(!slot.claimed.load(std::memory_order_relaxed) && slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+         return &slot;
+      }
+   }
+   return nullptr;
+};
+
+// latest value per key for keys 0 to n_keys - 1, written by a single writer. every store marks the key in one dirty
+// bitmap per reader, readers visit only the keys changed since their previous scan instead of polling every element
+template<typename T, std::uint32_t n_keys_, std::uint32_t max_readers, bool accept_UB>
+requires (n_keys_ > 0) && (max_readers > 0) && std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+struct LastValueCache {
+private:
+   static constexpr std::uint32_t n_keys = n_keys_;
+   using ElementsType = KeyedElements<T, n_keys, accept_UB>;
+   using BitmapType = DirtyBitmap<n_keys>;
+   ElementsType elements;
+   const std::unique_ptr<std::array<BitmapType, max_readers>> bitmaps;
+
+   struct CacheReader {
+   private:
+      const LastValueCache* const cache_ptr;
+      // nullptr if max_readers readers exist already
+      BitmapType* const bitmap;
+
+   public:
+      explicit CacheReader(const LastValueCache*, BitmapType*) noexcept;
+      ~CacheReader();
+      CacheReader(const CacheReader&) = delete;
+      CacheReader& operator=(const CacheReader&) = delete;
+      CacheReader(CacheReader&&) = delete;
+      CacheReader& operator=(CacheReader&&) = delete;
+      // calls f(key, value) with the latest value of every key stored since the previous call (or since the reader was
+      // created), in ascending order of keys. a key stored several times in between is visited once. returns the number
+      // of keys visited
+      template<typename F>
+      std::uint32_t for_each_changed(F&&) noexcept;
+      bool is_attached() const noexcept;
+   };
+
+public:
+   using ValueType = T;
+   static constexpr std::uint32_t capacity = n_keys;
+   static constexpr std::size_t element_size = ElementsType::element_size;
+   explicit LastValueCache();
+   ~LastValueCache() = default;
+   LastValueCache(const LastValueCache&) = delete;
+   LastValueCache& operator=(const LastValueCache&) = delete;
+   LastValueCache(LastValueCache&&) = delete;
+   LastValueCache& operator=(LastValueCache&&) = delete;
+   using ReaderType = CacheReader;
+   // key needs to be smaller than capacity
+   void store(const std::uint32_t, const T&) noexcept;
+   // latest value of key, default constructed if it hasn't been stored yet
+   T load(const std::uint32_t) const noexcept;
+   // reader with a dirty bitmap of its own, detached (is_attached() returns false, for_each_changed never visits any
+   // key) if max_readers readers exist already. stores concurrent with attaching may not be visited, a reader needing
+   // every value loads all keys once after attaching
+   CacheReader get_reader() const noexcept;
+};
+} // namespace Cache
+
+#define TEMPLATE_PARAMS                                                                            \
+   template<typename T, std::uint32_t n_keys_, std::uint32_t max_readers, bool accept_UB>          \
+   requires (n_keys_ > 0) && (max_readers > 0) && std::is_default_constructible_v<T> && std::is_trivially_copyable_v<T> && (!std::is_const_v<T>) && std::atomic<std::int64_t>::is_always_lock_free
+
+#define LAST_VALUE_CACHE Cache::LastValueCache<T, n_keys_, max_readers, accept_UB>
+
+TEMPLATE_PARAMS
+LAST_VALUE_CACHE::LastValueCache():
+    bitmaps{new std::array<BitmapType, max_readers>()} {};
+
+TEMPLATE_PARAMS
+void LAST_VALUE_CACHE::store(const std::uint32_t key, const T& value) noexcept {
+   this->elements.store(key, value);
+   for(BitmapType& bitmap : *this->bitmaps) {
+      if(bitmap.active.load(std::memory_order_acquire)) {
+         bitmap.mark(key);
+      }
+   }
+};
+
+TEMPLATE_PARAMS
+T LAST_VALUE_CACHE::load(const std::uint32_t key) const noexcept {
+   return this->elements.load(key);
+};
+
+TEMPLATE_PARAMS
+LAST_VALUE_CACHE::CacheReader LAST_VALUE_CACHE::get_reader() const noexcept {
+   BitmapType* const bitmap = claim_slot(*this->bitmaps);
+   if(bitmap != nullptr) {
+      // bitmap is cleared before it is marked again, stores concurrent with attaching may be missed
+      bitmap->clear();
+      bitmap->active.store(true, std::memory_order_release);
+   }
+   return CacheReader(this, bitmap);
+};
+
+TEMPLATE_PARAMS
+LAST_VALUE_CACHE::CacheReader::CacheReader(const LAST_VALUE_CACHE* cache_ptr_, BitmapType* bitmap_) noexcept
+    :
+    cache_ptr(cache_ptr_),
+    bitmap(bitmap_) {};
+
+TEMPLATE_PARAMS
+LAST_VALUE_CACHE::CacheReader::~CacheReader() {
+   if(this->bitmap != nullptr) {
+      this->bitmap->active.store(false, std::memory_order_relaxed);
+      this->bitmap->claimed.store(false, std::memory_order_release);
+   }
+};
+
+TEMPLATE_PARAMS
+template<typename F>
+std::uint32_t LAST_VALUE_CACHE::CacheReader::for_each_changed(F&& f) noexcept {
+   if(this->bitmap == nullptr) {
+      return 0;
+   }
+   return this->bitmap->drain([this, &f](const std::uint32_t key) {
+      f(key, this->cache_ptr->load(key));
+   });
+};
+
+TEMPLATE_PARAMS
+bool LAST_VALUE_CACHE::CacheReader::is_attached() const noexcept {
+   return this->bitmap != nullptr;
+};
+
+#undef TEMPLATE_PARAMS
+#undef LAST_VALUE_CACHE
@@ -3,52 +3,117 @@
 #include <algorithm>
 #include <bit>
 #include <cstdint>
+#include <memory>
 #include <new>
 #include <optional>
 #include <span>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #include "Element.hpp"
+#include "Registry.hpp"
 #include "SLQ_Auxil.hpp"
+#include "Stats.hpp"
+#include "Tracing.hpp"
 
 namespace Queue {
-template<typename ContentType_, std::uint32_t length_, bool share_cacheline, bool accept_UB>
-requires (std::has_single_bit(length_)) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free
+template<typename ContentType_, std::uint32_t length_, bool share_cacheline, bool accept_UB, bool double_buffer = false, std::uint32_t prefetch_distance = 0, bool collect_stats = false, std::uint32_t timestamp_every = 0, bool named_readers = false>
+requires (std::has_single_bit(length_)) && (prefetch_distance < length_) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free
 struct SeqLockQueue {
 private:
    static constexpr size_t cacheline = 64;
    static constexpr std::uint32_t length = length_;
-   static constexpr size_t default_alignment = alignof(Element::SeqLockElement<SLQ_Auxil::UB_or_not_UB<ContentType_, accept_UB>, 0>);
-   static constexpr size_t element_alignment = share_cacheline * SLQ_Auxil::divisible_or_ceil(default_alignment, cacheline) + cacheline * !share_cacheline * (default_alignment / cacheline + 1 * (default_alignment % cacheline != 0));
+   static constexpr bool timestamping = timestamp_every > 0;
+   // every timestamp_every-th entry is stored along with the time it was enqueued at
+   using StoredType = std::conditional_t<timestamping, SLQ_Auxil::Timestamped<ContentType_>, ContentType_>;
+   template<std::uint32_t alignment>
+   using ElementTemplate = std::conditional_t<double_buffer,
+      Element::DoubleBufferedElement<SLQ_Auxil::UB_or_not_UB<StoredType, accept_UB>, alignment>,
+      Element::SeqLockElement<SLQ_Auxil::UB_or_not_UB<StoredType, accept_UB>, alignment>>;
+   static constexpr size_t default_alignment = alignof(ElementTemplate<0>);
+   // natural alignment of the element rounded up to a divisor of the cacheline size if elements may share a cacheline,
+   // to a multiple of it (i.e. every element starts a new cacheline) otherwise
+   static constexpr size_t element_alignment = share_cacheline ? SLQ_Auxil::divisible_or_ceil(default_alignment, cacheline)
+                                                               : SLQ_Auxil::ceil_(default_alignment, cacheline);
 
    static constexpr size_t memory_alignment = std::max(cacheline, element_alignment);
-   using ElementType = Element::SeqLockElement<SLQ_Auxil::UB_or_not_UB<ContentType_, accept_UB>, element_alignment>;
-   using ReadReturnType = std::tuple<std::optional<ContentType_>, std::int64_t>;
+   using ElementType = ElementTemplate<element_alignment>;
+   using ReadReturnType = std::tuple<std::optional<StoredType>, std::int64_t>;
    const std::unique_ptr<ElementType[]> memory_pointer;
    // data used by dequeueing thread
    const std::span<ElementType, length> dequeue_span;
    // data used by enqueueing thread
-   alignas(cacheline) std::int64_t enqueue_index = 0;
+   // only written by the enqueueing thread, atomic so that a monitor can sample the producer's position
+   alignas(cacheline) std::atomic<std::int64_t> enqueue_index = 0;
    const std::span<ElementType, length> enqueue_span;
+   [[no_unique_address]] Stats::ProducerStats<collect_stats> producer_stats;
+
+   // stands in for members of disabled features, distinct per member so that they all take up no space
+   template<typename>
+   struct Absent {};
+
+   // entries left until the next one is time stamped, spares the producer a division per entry
+   [[no_unique_address]] std::conditional_t<timestamping, std::uint32_t, Absent<std::uint32_t>> timestamp_countdown{};
+
+   // positions of named readers, only allocated if named_readers == true
+   [[no_unique_address]] std::conditional_t<named_readers, std::unique_ptr<Registry::ReaderRegistry>, Absent<Registry::ReaderRegistry>> registry;
+   using RegistrySlotType = std::conditional_t<named_readers, Registry::ReaderSlot*, Absent<Registry::ReaderSlot*>>;
 
    struct QueueReader {
    private:
       const SeqLockQueue* const queue_ptr;
       std::int64_t read_index = 0;
       std::int64_t prev_version = 1;
+      [[no_unique_address]] Stats::ReaderStats<collect_stats> own_stats;
+      // nullptr unless the reader has been registered under a name
+      [[no_unique_address]] const RegistrySlotType registry_slot;
+      // counters of a registered reader live in its registry slot so that monitors can sample them, own_stats otherwise
+      [[no_unique_address]] std::conditional_t<collect_stats, Stats::ReaderStats<true>*, Absent<Stats::ReaderStats<true>*>> stats{};
+      // time stamp of the entry read last, 0 if it wasn't sampled
+      [[no_unique_address]] std::conditional_t<timestamping, std::uint64_t, Absent<std::uint64_t>> last_timestamp{};
 
    public:
-      explicit QueueReader(const SeqLockQueue*) noexcept;
+      // a reader starting at start_index skips every entry enqueued before it
+      explicit QueueReader(const SeqLockQueue*, RegistrySlotType = {}, const std::int64_t start_index = 0) noexcept;
+      // only readers of queues with named readers may hold a registry slot to release
+      ~QueueReader() requires named_readers;
       ~QueueReader() = default;
       QueueReader(const QueueReader&) = delete;
       QueueReader& operator=(const QueueReader&) = delete;
       QueueReader(QueueReader&&) = delete;
       QueueReader& operator=(QueueReader&&) = delete;
       std::optional<ContentType_> read_next_entry() noexcept;
+      template<std::uint32_t read_prefetch_distance = 8>
+      std::uint32_t read_next_entries(std::span<ContentType_>) noexcept;
+      // all zero unless collect_stats == true
+      Stats::ReaderSnapshot get_stats() const noexcept;
+      bool is_registered() const noexcept;
+      // SLQ_Auxil::read_tsc() value at which the entry read last was enqueued, nullopt if it wasn't sampled or
+      // timestamp_every == 0. SLQ_Auxil::read_tsc() minus this value is the time the entry spent in the queue
+      std::optional<std::uint64_t> last_enqueue_timestamp() const noexcept;
    };
 
 public:
    using ContentType = ContentType_;
+   // compile time layout report
+   static constexpr size_t element_size = sizeof(ElementType);
+   static constexpr size_t alignment = element_alignment;
+   // 0 if an element occupies more than one cacheline
+   static constexpr size_t elements_per_cacheline = element_size <= cacheline ? cacheline / element_size : 0;
+   // most cachelines any element touches, elements not aligned to cachelines may reach into one line more than their
+   // size requires
+   static constexpr size_t cachelines_per_element = SLQ_Auxil::max_lines_spanned(element_size, cacheline);
+   // elements sharing cachelines whose size doesn't divide the cacheline size, e.g. 24 bytes, span two cachelines every
+   // now and then
+   static constexpr bool elements_straddle_cachelines = cacheline % element_size != 0 && element_size % cacheline != 0;
+   // bytes per element that don't hold the payload: version, time stamp, padding and, for double buffered elements, the
+   // second copy
+   static constexpr size_t padding_per_element = element_size - sizeof(ContentType_);
+   static constexpr double padding_fraction = static_cast<double>(padding_per_element) / element_size;
+   // number of entries the ring buffer holds
+   static constexpr std::uint32_t capacity = length;
+   static constexpr size_t footprint = element_size * length;
    explicit SeqLockQueue();
    ~SeqLockQueue() = default;
    SeqLockQueue(const SeqLockQueue&) = delete;
@@ -58,50 +123,202 @@ public:
    using ReaderType = QueueReader;
    void enqueue(const ContentType) noexcept;
    ReadReturnType read_element(std::int64_t, std::int64_t) const noexcept;
+   template<typename StatsType>
+   ReadReturnType read_element(std::int64_t, std::int64_t, StatsType&) const noexcept;
+   void prefetch_element(std::int64_t) const noexcept;
    QueueReader get_reader() const noexcept;
+   // reader publishing its position under name (truncated to Registry::max_name_length characters), the reader stays
+   // anonymous if Registry::max_readers named readers exist already
+   QueueReader get_reader(std::string_view) const noexcept
+   requires named_readers;
+   // reader starting at the producer's current position, i.e. skipping every entry enqueued before it was created
+   // instead of reading whatever is left of them in the buffer
+   QueueReader get_reader_at_producer() const noexcept;
+   // number of entries enqueued so far
+   std::int64_t get_producer_position() const noexcept;
+   // lag of every named reader, returns the number of readers written to the span, always 0 unless named_readers == true
+   std::uint32_t sample_reader_lags(std::span<Registry::ReaderLag>) const noexcept;
+   // all zero unless collect_stats == true
+   Stats::ProducerSnapshot get_producer_stats() const noexcept;
 };
 } // namespace SeqLockQueue
 
 #define TEMPLATE_PARAMS                                                                         \
-   template<typename ContentType_, std::uint32_t length_, bool share_cacheline, bool accept_UB> \
-   requires (std::has_single_bit(length_)) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free
+   template<typename ContentType_, std::uint32_t length_, bool share_cacheline, bool accept_UB, bool double_buffer, std::uint32_t prefetch_distance, bool collect_stats, std::uint32_t timestamp_every, bool named_readers> \
+   requires (std::has_single_bit(length_)) && (prefetch_distance < length_) && std::is_default_constructible_v<ContentType_> && std::is_trivially_copyable_v<ContentType_> && (!std::is_const_v<ContentType_>) && std::atomic<std::int64_t>::is_always_lock_free
 
 #define SEQ_LOCK_QUEUE \
-   Queue::SeqLockQueue<ContentType_, length_, share_cacheline, accept_UB>
+   Queue::SeqLockQueue<ContentType_, length_, share_cacheline, accept_UB, double_buffer, prefetch_distance, collect_stats, timestamp_every, named_readers>
 
 TEMPLATE_PARAMS
 SEQ_LOCK_QUEUE::SeqLockQueue():
     memory_pointer{new(std::align_val_t{memory_alignment}) ElementType[length]()},
     dequeue_span{this->memory_pointer.get(), length},
-    enqueue_span{this->memory_pointer.get(), length} {};
+    enqueue_span{this->memory_pointer.get(), length} {
+   if constexpr(named_readers) {
+      this->registry.reset(new Registry::ReaderRegistry());
+   }
+};
 
 TEMPLATE_PARAMS
 SEQ_LOCK_QUEUE::ReadReturnType SEQ_LOCK_QUEUE::read_element(std::int64_t read_index, std::int64_t prev_version) const noexcept {
    return this->dequeue_span[read_index % length].read(prev_version);
 };
 
+TEMPLATE_PARAMS
+template<typename StatsType>
+SEQ_LOCK_QUEUE::ReadReturnType SEQ_LOCK_QUEUE::read_element(std::int64_t read_index, std::int64_t prev_version, StatsType& stats) const noexcept {
+   return this->dequeue_span[read_index % length].read(prev_version, stats);
+};
+
+TEMPLATE_PARAMS
+void SEQ_LOCK_QUEUE::prefetch_element(std::int64_t read_index) const noexcept {
+   SLQ_Auxil::prefetch_read(&this->dequeue_span[read_index % length]);
+};
+
 TEMPLATE_PARAMS
 void SEQ_LOCK_QUEUE::enqueue(const ContentType_ content_) noexcept {
-   this->enqueue_span[this->enqueue_index % length].insert(content_);
-   ++this->enqueue_index;
+   const std::int64_t index = this->enqueue_index.load(std::memory_order_relaxed);
+   SLQ_TRACEPOINT1(enqueue, index);
+   // element prefetch_distance entries ahead is likely to be held in shared state by polling readers
+   if constexpr(prefetch_distance > 0) {
+      SLQ_Auxil::prefetch_write(&this->enqueue_span[(index + prefetch_distance) % length]);
+   }
+   if constexpr(timestamping) {
+      const bool sampled = this->timestamp_countdown == 0;
+      this->timestamp_countdown = sampled ? timestamp_every - 1 : this->timestamp_countdown - 1;
+      this->enqueue_span[index % length].insert(StoredType{content_, sampled ? SLQ_Auxil::read_tsc() : 0});
+   }
+   else {
+      this->enqueue_span[index % length].insert(content_);
+   }
+   this->enqueue_index.store(index + 1, std::memory_order_relaxed);
+   this->producer_stats.message_written();
 };
 
 TEMPLATE_PARAMS
-SEQ_LOCK_QUEUE::QueueReader::QueueReader(const SEQ_LOCK_QUEUE* queue_ptr_) noexcept
+SEQ_LOCK_QUEUE::QueueReader::QueueReader(const SEQ_LOCK_QUEUE* queue_ptr_, RegistrySlotType registry_slot_, const std::int64_t start_index) noexcept
     :
-    queue_ptr(queue_ptr_) {};
+    queue_ptr(queue_ptr_),
+    read_index(start_index),
+    // the element at start_index completes version 2 * (start_index / length + 1) when it's written in start_index's lap
+    prev_version(2 * (start_index / length) + 1),
+    registry_slot(registry_slot_) {
+   if constexpr(collect_stats && named_readers) {
+      this->stats = registry_slot_ != nullptr ? &registry_slot_->stats : &this->own_stats;
+   }
+   else if constexpr(collect_stats) {
+      this->stats = &this->own_stats;
+   }
+};
+
+TEMPLATE_PARAMS
+SEQ_LOCK_QUEUE::QueueReader::~QueueReader()
+requires named_readers
+{
+   if(this->registry_slot != nullptr) {
+      this->queue_ptr->registry->release(this->registry_slot);
+   }
+};
 
 TEMPLATE_PARAMS
 std::optional<ContentType_> SEQ_LOCK_QUEUE::QueueReader::read_next_entry() noexcept {
-   const auto read_result = this->queue_ptr->read_element(this->read_index, this->prev_version);
+   const auto read_result = [this]() {
+      if constexpr(collect_stats) {
+         return this->queue_ptr->read_element(this->read_index, this->prev_version, *this->stats);
+      }
+      else {
+         return this->queue_ptr->read_element(this->read_index, this->prev_version);
+      }
+   }();
    const auto ret_opt = std::get<0>(read_result);
    const bool new_entry_read = ret_opt.has_value();
+   SLQ_TRACEPOINT3(read_next_entry, this->read_index, std::get<1>(read_result), new_entry_read);
+   if constexpr(collect_stats) {
+      if(new_entry_read) {
+         this->stats->message_read();
+         // version expected at this position if the producer hasn't lapped the reader, every lap it got ahead by
+         // overwrote length entries the reader never saw
+         const std::int64_t expected_version = (this->prev_version + 1) & ~std::int64_t{1};
+         const std::int64_t laps_behind = (std::get<1>(read_result) - expected_version) / 2;
+         if(laps_behind > 0) {
+            this->stats->overrun(laps_behind * length);
+         }
+      }
+      else {
+         this->stats->empty_poll();
+      }
+   }
    this->prev_version = new_entry_read ?
       std::get<1>(read_result)
          // when buffer position wraps, the version number of the next read must be larger than the previous one or the first entry in the buffer will be read twice
          + 2 * (this->read_index % length == length - 1) : this->prev_version;
    this->read_index += new_entry_read;
-   return ret_opt;
+   // published on the reader's own registry cacheline, read only by monitors
+   if constexpr(named_readers) {
+      if(new_entry_read && this->registry_slot != nullptr) {
+         this->registry_slot->position.store(this->read_index, std::memory_order_relaxed);
+      }
+   }
+   if constexpr(timestamping) {
+      if(!new_entry_read) {
+         return std::nullopt;
+      }
+      this->last_timestamp = ret_opt->timestamp;
+      return ret_opt->payload;
+   }
+   else {
+      return ret_opt;
+   }
+};
+
+TEMPLATE_PARAMS
+template<std::uint32_t read_prefetch_distance>
+std::uint32_t SEQ_LOCK_QUEUE::QueueReader::read_next_entries(std::span<ContentType_> dest) noexcept {
+   // reads up to dest.size() entries, stops at the first entry that hasn't been written yet
+   std::uint32_t n_read = 0;
+   for(; n_read < dest.size(); ++n_read) {
+      // a reader far behind the producer walks the buffer sequentially, fetching elements ahead hides the cache misses
+      if constexpr(read_prefetch_distance > 0) {
+         this->queue_ptr->prefetch_element(this->read_index + read_prefetch_distance);
+      }
+      const auto entry = this->read_next_entry();
+      if(!entry.has_value()) {
+         break;
+      }
+      dest[n_read] = entry.value();
+   }
+   return n_read;
+};
+
+TEMPLATE_PARAMS
+Stats::ReaderSnapshot SEQ_LOCK_QUEUE::QueueReader::get_stats() const noexcept {
+   if constexpr(collect_stats) {
+      return this->stats->snapshot();
+   }
+   else {
+      return this->own_stats.snapshot();
+   }
+};
+
+TEMPLATE_PARAMS
+bool SEQ_LOCK_QUEUE::QueueReader::is_registered() const noexcept {
+   if constexpr(named_readers) {
+      return this->registry_slot != nullptr;
+   }
+   else {
+      return false;
+   }
+};
+
+TEMPLATE_PARAMS
+std::optional<std::uint64_t> SEQ_LOCK_QUEUE::QueueReader::last_enqueue_timestamp() const noexcept {
+   if constexpr(timestamping) {
+      return this->last_timestamp != 0 ? std::optional<std::uint64_t>{this->last_timestamp} : std::nullopt;
+   }
+   else {
+      return std::nullopt;
+   }
 };
 
 TEMPLATE_PARAMS
@@ -109,5 +326,37 @@ SEQ_LOCK_QUEUE::QueueReader SEQ_LOCK_QUEUE::get_reader() const noexcept {
    return QueueReader(this);
 };
 
+TEMPLATE_PARAMS
+SEQ_LOCK_QUEUE::QueueReader SEQ_LOCK_QUEUE::get_reader(std::string_view name) const noexcept
+requires named_readers
+{
+   return QueueReader(this, this->registry->claim(name, 0));
+};
+
+TEMPLATE_PARAMS
+SEQ_LOCK_QUEUE::QueueReader SEQ_LOCK_QUEUE::get_reader_at_producer() const noexcept {
+   return QueueReader(this, {}, this->get_producer_position());
+};
+
+TEMPLATE_PARAMS
+std::int64_t SEQ_LOCK_QUEUE::get_producer_position() const noexcept {
+   return this->enqueue_index.load(std::memory_order_relaxed);
+};
+
+TEMPLATE_PARAMS
+std::uint32_t SEQ_LOCK_QUEUE::sample_reader_lags(std::span<Registry::ReaderLag> dest) const noexcept {
+   if constexpr(named_readers) {
+      return this->registry->sample(dest, this->get_producer_position());
+   }
+   else {
+      return 0;
+   }
+};
+
+TEMPLATE_PARAMS
+Stats::ProducerSnapshot SEQ_LOCK_QUEUE::get_producer_stats() const noexcept {
+   return this->producer_stats.snapshot();
+};
+
 #undef TEMPLATE_PARAMS
 #undef SEQ_LOCK_QUEUE
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "SLQ_Auxil.hpp"
+#include "Stats.hpp"
+
+// named readers publish their position, each on a cacheline only they write to, so that a monitor can sample how far
+// behind the producer every one of them is without touching the lines the producer and the readers work on
+namespace Registry {
+inline constexpr std::uint32_t max_readers = 64;
+inline constexpr std::size_t max_name_length = 47;
+
+using NameType = std::array<char, max_name_length + 1>;
+
+struct alignas(SLQ_Auxil::cacheline) ReaderSlot {
+   std::atomic<bool> claimed = false;
+   // odd while a reader is registered, bumped on registration and release so that a monitor can detect a slot being
+   // reused while it was sampled
+   std::atomic<std::uint32_t> generation = 0;
+   // queue index of the next entry the reader is going to read
+   std::atomic<std::int64_t> position = 0;
+   SLQ_Auxil::atomic_arr_copy_t<NameType> name;
+   // counted into by the registered reader if its queue collects statistics, zero otherwise
+   Stats::ReaderStats<true> stats;
+};
+
+struct ReaderLag {
+   NameType name;
+   std::int64_t position = 0;
+   // number of entries the producer is ahead of the reader, the reader has been lapped if it exceeds the queue's length
+   std::int64_t lag = 0;
+   // all zero unless the queue collects statistics
+   Stats::ReaderSnapshot stats;
+};
+
+struct ReaderRegistry {
+private:
+   std::array<ReaderSlot, max_readers> slots;
+
+public:
+   // nullptr if all slots are taken
+   ReaderSlot* claim(std::string_view, const std::int64_t) noexcept;
+   void release(ReaderSlot*) noexcept;
+   // fills dest with the registered readers' lags relative to producer_position, returns the number of readers written
+   std::uint32_t sample(std::span<ReaderLag>, const std::int64_t) const noexcept;
+};
+
+inline ReaderSlot* ReaderRegistry::claim(std::string_view name, const std::int64_t position) noexcept {
+   for(ReaderSlot& slot : this->slots) {
+      bool expected = false;
+      if(slot.claimed.load(std::memory_order_relaxed) || !slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+         continue;
+      }
+      NameType truncated{};
+      name.copy(truncated.data(), max_name_length);
+      slot.name = SLQ_Auxil::atomic_arr_copy_t<NameType>(truncated);
+      slot.position.store(position, std::memory_order_relaxed);
+      slot.stats.reset();
+      // name, position and statistics need to be visible before the slot shows up as registered
+      slot.generation.store(slot.generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+      return &slot;
+   }
+   return nullptr;
+};
+
+inline void ReaderRegistry::release(ReaderSlot* slot) noexcept {
+   slot->generation.store(slot->generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+   slot->claimed.store(false, std::memory_order_release);
+};
+
+inline std::uint32_t ReaderRegistry::sample(std::span<ReaderLag> dest, const std::int64_t producer_position) const noexcept {
+   std::uint32_t n_sampled = 0;
+   for(const ReaderSlot& slot : this->slots) {
+      if(n_sampled == dest.size()) {
+         break;
+      }
+      const std::uint32_t initial_generation = slot.generation.load(std::memory_order_acquire);
+      if(initial_generation % 2 == 0) {
+         continue;
+      }
+      ReaderLag& sampled = dest[n_sampled];
+      // the name may be rewritten concurrently if the slot gets reused, it is thus copied atomically
+      SLQ_Auxil::atomic_arr_copy_t<NameType> name_copy;
+      name_copy = slot.name;
+      sampled.name = name_copy;
+      sampled.position = slot.position.load(std::memory_order_relaxed);
+      sampled.stats = slot.stats.snapshot();
+      SLQ_Auxil::load_fence();
+      // slot has been released (and possibly reused) while being sampled
+      if(slot.generation.load(std::memory_order_relaxed) != initial_generation) {
+         continue;
+      }
+      // the producer's position may have been loaded before the reader caught up with it
+      sampled.lag = std::max<std::int64_t>(0, producer_position - sampled.position);
+      ++n_sampled;
+   }
+   return n_sampled;
+};
+} // namespace Registry
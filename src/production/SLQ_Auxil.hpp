@@ -1,12 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <bit>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <span>
 #include <type_traits>
 #include <utility>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 namespace SLQ_Auxil {
+// smallest multiple of i2 that is >= i1, e.g. ceil_(72, 64) == 128
 template<typename I>
 requires std::unsigned_integral<I>
 constexpr I ceil_(I i1, I i2) {
@@ -18,6 +27,7 @@ constexpr I ceil_(I i1, I i2) {
    }
 };
 
+// smallest divisor of i2 that is >= i1, e.g. divisible_(24, 64) == 32
 template<typename I>
 requires std::unsigned_integral<I>
 constexpr I divisible_(I i1, I i2) {
@@ -29,6 +39,9 @@ constexpr I divisible_(I i1, I i2) {
    }
 };
 
+// divisible_(i1, i2) if i1 < i2, ceil_(i1, i2) otherwise. with i2 the size of a cacheline and i1 an alignment: the
+// smallest alignment >= i1 that both lets several elements share a cacheline and keeps cacheline boundaries aligned,
+// e.g. for i2 == 64: 8 -> 8, 24 -> 32, 64 -> 64, 72 -> 128
 template<typename I>
 requires std::unsigned_integral<I>
 constexpr I divisible_or_ceil(I i1, I i2) {
@@ -40,6 +53,92 @@ constexpr I divisible_or_ceil(I i1, I i2) {
    }
 };
 
+// most cachelines an element of size i1 touches if elements are laid out back to back from a boundary of i2 sized
+// cachelines, e.g. for i2 == 64: 16 -> 1, 24 -> 2, 112 -> 3 (the element at offset 48 reaches into a third line)
+template<typename I>
+requires std::unsigned_integral<I>
+constexpr I max_lines_spanned(I i1, I i2) {
+   I max_lines = 0;
+   // offsets within a cacheline repeat after i2 elements at the latest
+   for(I i = 0; i < i2; ++i) {
+      const I lines = static_cast<I>((i * i1 % i2 + i1 + i2 - 1) / i2);
+      max_lines = lines > max_lines ? lines : max_lines;
+   }
+   return max_lines;
+};
+
+// x86 is TSO: stores are not reordered with older stores and loads are not reordered with older loads
+// the hardware thus already orders the version and content accesses of a seq-lock, only the compiler needs to be restrained
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+inline constexpr bool tso_fast_path = true;
+#else
+inline constexpr bool tso_fast_path = false;
+#endif
+
+// orders a preceding store of an odd version before subsequent stores of the content
+inline void store_fence() noexcept {
+   if constexpr(tso_fast_path) {
+      std::atomic_signal_fence(std::memory_order_release);
+   }
+   else {
+      std::atomic_thread_fence(std::memory_order_release);
+   }
+};
+
+// orders preceding loads of the content before a subsequent load of the version
+inline void load_fence() noexcept {
+   if constexpr(tso_fast_path) {
+      std::atomic_signal_fence(std::memory_order_acquire);
+   }
+   else {
+      std::atomic_thread_fence(std::memory_order_acquire);
+   }
+};
+
+inline constexpr std::size_t cacheline = 64;
+
+// number of slots of type T fitting into one cacheline next to a block's version and end index, rounded down to a power of two
+template<typename T>
+constexpr std::uint32_t block_slots() {
+   constexpr std::size_t block_header = 2 * sizeof(std::int64_t);
+   return static_cast<std::uint32_t>(std::bit_floor((cacheline - block_header) / sizeof(T)));
+};
+
+// requests ownership of the cacheline at address ahead of a write, so the write itself doesn't stall on the read-for-ownership
+// (emitted as prefetchw on x86 if the target supports it, e.g. via -mprfchw or -march=native, as prefetcht0 otherwise)
+inline void prefetch_write(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+   __builtin_prefetch(address, 1, 3);
+#endif
+};
+
+// pulls the cacheline at address into all cache levels ahead of a read
+inline void prefetch_read(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+   __builtin_prefetch(address, 0, 3);
+#endif
+};
+
+// time stamp counter if available, steady_clock nanoseconds otherwise
+inline std::uint64_t read_tsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+   return __rdtsc();
+#else
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+};
+
+// payload stored next to the time stamp counter value at which it was enqueued, 0 if the entry wasn't sampled
+template<typename T>
+struct Timestamped {
+   T payload;
+   std::uint64_t timestamp = 0;
+};
+
+// payloads larger than this are read in cacheline-sized chunks, validating the version after each chunk
+inline constexpr std::size_t chunked_read_threshold = 1024;
+inline constexpr std::size_t chunk_size = cacheline;
+
 template<typename...>
 struct atomic_arr_copy {
    static_assert(false);
@@ -52,7 +151,7 @@ requires std::is_trivially_copyable_v<T>
 struct atomic_arr_copy<T, std::integer_sequence<size_t, indices...>> {
 private:
    static constexpr size_t size = sizeof(T);
-   using SrcSpanType = const std::span<const char, size>;
+   using SrcSpanType = const std::span<const std::atomic<char>, size>;
    using DestSpanType = std::span<std::atomic<char>, size>;
    T value;
 
@@ -69,10 +168,10 @@ public:
 
    atomic_arr_copy& operator=(const atomic_arr_copy& other) {
       // make relevant sections of memory accessible via std::span
-      const auto source = SrcSpanType{reinterpret_cast<const char*>(&other.value), size};
+      const auto source = SrcSpanType{reinterpret_cast<const std::atomic<char>*>(&other.value), size};
       auto dest = DestSpanType{reinterpret_cast<std::atomic<char>*>(&this->value), size};
-      // atomically copy data
-      (dest[indices].store(source[indices], std::memory_order_relaxed), ...);
+      // atomically copy data, both sides need to be accessed atomically since either one may be shared with another thread
+      (dest[indices].store(source[indices].load(std::memory_order_relaxed), std::memory_order_relaxed), ...);
       return *this;
    };
 
@@ -80,6 +179,15 @@ public:
       *this = other;
    };
 
+   // atomically copies length bytes starting at offset, used to read large payloads chunk by chunk
+   void copy_chunk(const atomic_arr_copy& other, size_t offset, size_t length) noexcept {
+      const auto source = reinterpret_cast<const std::atomic<char>*>(&other.value) + offset;
+      auto dest = reinterpret_cast<std::atomic<char>*>(&this->value) + offset;
+      for(size_t i = 0; i < length; ++i) {
+         dest[i].store(source[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+      }
+   };
+
    atomic_arr_copy& operator=(const atomic_arr_copy&& other) {
       return operator=(other);
    };
@@ -119,6 +227,13 @@ public:
       *this = other;
    };
 
+   // copies length bytes starting at offset, used to read large payloads chunk by chunk
+   void copy_chunk(const atomic_arr_copy_standin& other, size_t offset, size_t length) noexcept
+   requires std::is_trivially_copyable_v<T>
+   {
+      std::memcpy(reinterpret_cast<char*>(&this->value) + offset, reinterpret_cast<const char*>(&other.value) + offset, length);
+   };
+
    atomic_arr_copy_standin& operator=(const atomic_arr_copy_standin&& other) {
       return operator=(other);
    };
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "SLQ_Auxil.hpp"
+
+// hot path counters of readers and the producer, toggled at compile time: the disabled specializations are empty and
+// all of their member functions are no-ops, i.e. code using them compiles to the same instructions as code without
+namespace Stats {
+// counters are only ever written by the thread owning them, so increments don't need read-modify-write instructions,
+// they are atomic so that other threads can sample them
+inline void increment(std::atomic<std::uint64_t>& counter, const std::uint64_t n = 1) noexcept {
+   counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+};
+
+struct ReaderSnapshot {
+   std::uint64_t messages_read = 0;
+   // reads that found no new entry
+   std::uint64_t empty_polls = 0;
+   // copies discarded because a write overlapped with them
+   std::uint64_t retries = 0;
+   // iterations spent waiting for a write in progress to complete
+   std::uint64_t spin_iterations = 0;
+   // entries the reader never saw because the producer had overwritten them
+   std::uint64_t overruns = 0;
+};
+
+struct ProducerSnapshot {
+   std::uint64_t messages_written = 0;
+};
+
+template<bool enabled>
+struct ReaderStats;
+
+// on a cacheline of its own, so that counting doesn't cause false sharing with other readers or the producer
+template<>
+struct alignas(SLQ_Auxil::cacheline) ReaderStats<true> {
+   std::atomic<std::uint64_t> messages_read = 0;
+   std::atomic<std::uint64_t> empty_polls = 0;
+   std::atomic<std::uint64_t> retries = 0;
+   std::atomic<std::uint64_t> spin_iterations = 0;
+   std::atomic<std::uint64_t> overruns = 0;
+
+   void message_read() noexcept { increment(this->messages_read); };
+   void empty_poll() noexcept { increment(this->empty_polls); };
+   void retry() noexcept { increment(this->retries); };
+   void spin() noexcept { increment(this->spin_iterations); };
+   void overrun(const std::uint64_t n) noexcept { increment(this->overruns, n); };
+
+   // only to be called while no reader is counting
+   void reset() noexcept {
+      for(std::atomic<std::uint64_t>* counter : {&this->messages_read, &this->empty_polls, &this->retries, &this->spin_iterations, &this->overruns}) {
+         counter->store(0, std::memory_order_relaxed);
+      }
+   };
+
+   ReaderSnapshot snapshot() const noexcept {
+      return {this->messages_read.load(std::memory_order_relaxed), this->empty_polls.load(std::memory_order_relaxed),
+         this->retries.load(std::memory_order_relaxed), this->spin_iterations.load(std::memory_order_relaxed),
+         this->overruns.load(std::memory_order_relaxed)};
+   };
+};
+
+template<>
+struct ReaderStats<false> {
+   void message_read() noexcept {};
+   void empty_poll() noexcept {};
+   void retry() noexcept {};
+   void spin() noexcept {};
+   void overrun(const std::uint64_t) noexcept {};
+
+   ReaderSnapshot snapshot() const noexcept { return {}; };
+};
+
+template<bool enabled>
+struct ProducerStats;
+
+template<>
+struct alignas(SLQ_Auxil::cacheline) ProducerStats<true> {
+   std::atomic<std::uint64_t> messages_written = 0;
+
+   void message_written() noexcept { increment(this->messages_written); };
+
+   ProducerSnapshot snapshot() const noexcept { return {this->messages_written.load(std::memory_order_relaxed)}; };
+};
+
+template<>
+struct ProducerStats<false> {
+   void message_written() noexcept {};
+
+   ProducerSnapshot snapshot() const noexcept { return {}; };
+};
+} // namespace Stats
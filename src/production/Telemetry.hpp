@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Element.hpp"
+#include "Registry.hpp"
+#include "SLQ_Auxil.hpp"
+#include "Stats.hpp"
+
+// queue statistics mirrored into a POSIX shared memory segment that monitoring tools map read-only. the segment is
+// created and mapped once, publishing only writes to the mapped memory, i.e. it needs neither syscalls nor a thread of
+// its own and can be done from any thread the application already runs, e.g. in between bursts
+namespace Telemetry {
+// "SLQTELM1", written last when a segment is created, monitors reject segments without it
+inline constexpr std::uint64_t magic = 0x534c5154454c4d31;
+inline constexpr std::uint32_t layout_version = 1;
+
+struct Snapshot {
+   // steady_clock nanoseconds at which the snapshot was published, 0 if nothing has been published yet
+   std::int64_t published_ns = 0;
+   std::uint32_t queue_capacity = 0;
+   std::uint32_t n_readers = 0;
+   // number of entries enqueued so far
+   std::int64_t producer_position = 0;
+   // entries enqueued per second between the last two publications
+   double producer_rate = 0;
+   // all zero unless the queue collects statistics
+   Stats::ProducerSnapshot producer_stats;
+   // named readers only, the first n_readers entries are valid
+   std::array<Registry::ReaderLag, Registry::max_readers> readers{};
+};
+
+// monitors may be compiled separately from the publishing process, the header lets them check that both agree on the
+// layout of the snapshot
+struct Page {
+   std::atomic<std::uint64_t> magic = 0;
+   std::uint32_t layout_version = Telemetry::layout_version;
+   std::uint32_t snapshot_size = sizeof(Snapshot);
+   // snapshots are several kilobytes, byte wise atomic copies (accept_UB == false) of that size take minutes to
+   // compile. they are copied in chunks with memcpy instead, torn copies are discarded as they are for queue elements
+   Element::SeqLockElement<SLQ_Auxil::UB_or_not_UB<Snapshot, true>, SLQ_Auxil::cacheline> snapshot;
+};
+
+// shared memory object names need to start with a slash
+inline std::string object_name(std::string_view name) {
+   return name.starts_with('/') ? std::string(name) : "/" + std::string(name);
+};
+
+struct Publisher {
+private:
+   const std::string name;
+   Page* page = nullptr;
+   std::int64_t prev_position = 0;
+   std::int64_t prev_ns = 0;
+
+public:
+   // creates (or replaces) the segment, is_open() returns false if that failed
+   explicit Publisher(std::string_view);
+   // removes the segment, monitors that mapped it keep their mapping
+   ~Publisher();
+   Publisher(const Publisher&) = delete;
+   Publisher& operator=(const Publisher&) = delete;
+   Publisher(Publisher&&) = delete;
+   Publisher& operator=(Publisher&&) = delete;
+   bool is_open() const noexcept;
+   // snapshots producer position and rate, producer statistics and lag and statistics of every named reader of queue.
+   // not thread safe, a publisher is to be used by one thread at a time
+   template<typename QueueType>
+   void publish(const QueueType&) noexcept;
+};
+
+struct Monitor {
+private:
+   const Page* page = nullptr;
+
+public:
+   // maps the segment read-only, is_open() returns false if it doesn't exist or was published by an incompatible build
+   explicit Monitor(std::string_view);
+   ~Monitor();
+   Monitor(const Monitor&) = delete;
+   Monitor& operator=(const Monitor&) = delete;
+   Monitor(Monitor&&) = delete;
+   Monitor& operator=(Monitor&&) = delete;
+   bool is_open() const noexcept;
+   // latest snapshot, nullopt if the segment isn't mapped or if a snapshot stays in the middle of being published for
+   // max_read_attempts attempts, e.g. because the publishing process died while writing it
+   std::optional<Snapshot> read() const noexcept;
+   // publishing a snapshot takes a few microseconds, waiting for this many attempts takes several milliseconds
+   static constexpr std::uint64_t max_read_attempts = std::uint64_t{1} << 22;
+};
+
+inline Publisher::Publisher(std::string_view name_): name(object_name(name_)) {
+   ::shm_unlink(this->name.c_str());
+   const int fd = ::shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+   if(fd < 0) {
+      return;
+   }
+   void* const mapping = ::ftruncate(fd, sizeof(Page)) == 0 ? ::mmap(nullptr, sizeof(Page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                                                          : MAP_FAILED;
+   // the mapping stays valid after the descriptor is closed
+   ::close(fd);
+   if(mapping == MAP_FAILED) {
+      ::shm_unlink(this->name.c_str());
+      return;
+   }
+   this->page = new(mapping) Page();
+   // the page needs to be completely initialized before monitors accept it
+   this->page->magic.store(magic, std::memory_order_release);
+};
+
+inline Publisher::~Publisher() {
+   if(this->page != nullptr) {
+      ::munmap(this->page, sizeof(Page));
+      ::shm_unlink(this->name.c_str());
+   }
+};
+
+inline bool Publisher::is_open() const noexcept {
+   return this->page != nullptr;
+};
+
+template<typename QueueType>
+void Publisher::publish(const QueueType& queue) noexcept {
+   if(this->page == nullptr) {
+      return;
+   }
+   Snapshot snapshot;
+   snapshot.published_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   snapshot.queue_capacity = QueueType::capacity;
+   snapshot.producer_position = queue.get_producer_position();
+   if(this->prev_ns != 0 && snapshot.published_ns > this->prev_ns) {
+      snapshot.producer_rate = 1e9 * (snapshot.producer_position - this->prev_position) / (snapshot.published_ns - this->prev_ns);
+   }
+   this->prev_position = snapshot.producer_position;
+   this->prev_ns = snapshot.published_ns;
+   snapshot.producer_stats = queue.get_producer_stats();
+   snapshot.n_readers = queue.sample_reader_lags(snapshot.readers);
+   this->page->snapshot.insert(snapshot);
+};
+
+inline Monitor::Monitor(std::string_view name) {
+   const int fd = ::shm_open(object_name(name).c_str(), O_RDONLY, 0);
+   if(fd < 0) {
+      return;
+   }
+   // accessing a mapping beyond the end of a smaller segment would raise SIGBUS
+   struct stat segment_info;
+   const bool large_enough = ::fstat(fd, &segment_info) == 0 && static_cast<std::size_t>(segment_info.st_size) >= sizeof(Page);
+   void* const mapping = large_enough ? ::mmap(nullptr, sizeof(Page), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+   ::close(fd);
+   if(mapping == MAP_FAILED) {
+      return;
+   }
+   const Page* const mapped_page = static_cast<const Page*>(mapping);
+   if(mapped_page->magic.load(std::memory_order_acquire) != magic || mapped_page->layout_version != layout_version
+      || mapped_page->snapshot_size != sizeof(Snapshot)) {
+      ::munmap(mapping, sizeof(Page));
+      return;
+   }
+   this->page = mapped_page;
+};
+
+inline Monitor::~Monitor() {
+   if(this->page != nullptr) {
+      ::munmap(const_cast<Page*>(this->page), sizeof(Page));
+   }
+};
+
+inline bool Monitor::is_open() const noexcept {
+   return this->page != nullptr;
+};
+
+inline std::optional<Snapshot> Monitor::read() const noexcept {
+   if(this->page == nullptr) {
+      return std::nullopt;
+   }
+   // version 0 always returns the content unless the attempts run out
+   return std::get<0>(this->page->snapshot.try_read(0, max_read_attempts));
+};
+} // namespace Telemetry
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+// static user space tracepoints in the format of systemtap's sys/sdt.h, without depending on it. each tracepoint is a
+// single nop in the instruction stream plus a .note.stapsdt entry recording its address and where its arguments are
+// found, tracers (perf probe sdt_slq:*, bpftrace usdt:path:slq:*, ...) replace the nop with a breakpoint when they
+// attach. arguments are passed as signed 64 bit integers and only kept in registers or memory at the tracepoint, they
+// aren't computed for the tracer's sake
+// defining SLQ_NO_TRACEPOINTS removes them altogether
+#if !defined(SLQ_NO_TRACEPOINTS) && defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+#define SLQ_TRACEPOINTS_ENABLED 1
+
+// the .stapsdt.base section lets tracers adjust probe addresses in prelinked binaries, it is emitted only once per
+// object file
+#define SLQ_TRACEPOINT_NOTE(name, arg_format)                   \
+   "990: nop\n"                                                 \
+   ".pushsection .note.stapsdt,\"?\",\"note\"\n"                \
+   ".balign 4\n"                                                \
+   ".4byte 992f-991f, 994f-993f, 3\n"                           \
+   "991: .asciz \"stapsdt\"\n"                                  \
+   "992: .balign 4\n"                                           \
+   "993: .8byte 990b\n"                                         \
+   ".8byte _.stapsdt.base\n"                                    \
+   ".8byte 0\n"                                                 \
+   ".asciz \"slq\"\n"                                           \
+   ".asciz \"" #name "\"\n"                                     \
+   ".asciz \"" arg_format "\"\n"                                \
+   "994: .balign 4\n"                                           \
+   ".popsection\n"                                              \
+   ".ifndef _.stapsdt.base\n"                                   \
+   ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+   ".weak _.stapsdt.base\n"                                     \
+   ".hidden _.stapsdt.base\n"                                   \
+   "_.stapsdt.base: .space 1\n"                                 \
+   ".size _.stapsdt.base, 1\n"                                  \
+   ".popsection\n"                                              \
+   ".endif\n"
+
+#define SLQ_TRACEPOINT1(name, arg1) \
+   __asm__ __volatile__(SLQ_TRACEPOINT_NOTE(name, "-8@%[a1]") :: [a1] "nor"(static_cast<std::int64_t>(arg1)))
+
+#define SLQ_TRACEPOINT2(name, arg1, arg2)                           \
+   __asm__ __volatile__(SLQ_TRACEPOINT_NOTE(name, "-8@%[a1] -8@%[a2]") \
+                        :: [a1] "nor"(static_cast<std::int64_t>(arg1)), [a2] "nor"(static_cast<std::int64_t>(arg2)))
+
+#define SLQ_TRACEPOINT3(name, arg1, arg2, arg3)                              \
+   __asm__ __volatile__(SLQ_TRACEPOINT_NOTE(name, "-8@%[a1] -8@%[a2] -8@%[a3]") \
+                        :: [a1] "nor"(static_cast<std::int64_t>(arg1)), [a2] "nor"(static_cast<std::int64_t>(arg2)), \
+                        [a3] "nor"(static_cast<std::int64_t>(arg3)))
+
+#else
+#define SLQ_TRACEPOINTS_ENABLED 0
+#define SLQ_TRACEPOINT1(name, arg1)
+#define SLQ_TRACEPOINT2(name, arg1, arg2)
+#define SLQ_TRACEPOINT3(name, arg1, arg2, arg3)
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "Queue.hpp"
+
+namespace Queue {
+// index of T in Types, sizeof...(Types) if it isn't contained
+template<typename T, typename... Types>
+consteval std::size_t type_index() {
+   std::size_t index = 0;
+   ((!std::is_same_v<T, Types> && (++index, true)) && ...);
+   return index;
+};
+
+template<typename T, typename... Types>
+consteval std::size_t type_count() {
+   return (std::size_t{0} + ... + std::is_same_v<T, Types>);
+};
+
+template<typename... Types>
+consteval bool distinct_types() {
+   return ((type_count<Types, Types...>() == 1) && ...);
+};
+
+// raw storage large enough for the largest of MessageTypes plus a tag identifying the type currently held, trivially
+// copyable so that slots can be enqueued in a SeqLockQueue and copied without any per type logic
+template<typename... MessageTypes>
+struct TaggedSlot {
+   static constexpr std::size_t storage_size = std::max({sizeof(MessageTypes)...});
+   static constexpr std::size_t storage_alignment = std::max({alignof(MessageTypes)...});
+   using TagType = std::uint8_t;
+   template<std::size_t index>
+   using MessageType = std::tuple_element_t<index, std::tuple<MessageTypes...>>;
+
+   // bytes beyond the size of the message held are left uninitialized and never read as part of a message
+   alignas(storage_alignment) std::array<std::byte, storage_size> storage;
+   TagType tag;
+
+   template<typename T>
+   void store(const T& message) noexcept {
+      this->tag = static_cast<TagType>(type_index<T, MessageTypes...>());
+      std::memcpy(this->storage.data(), &message, sizeof(T));
+   };
+
+   template<std::size_t index>
+   MessageType<index> load() const noexcept {
+      MessageType<index> ret;
+      std::memcpy(&ret, this->storage.data(), sizeof(ret));
+      return ret;
+   };
+};
+
+// single producer, multiple consumer queue for a fixed list of message types that preserves the order of messages
+// across types. every slot holds a one byte tag plus storage for the largest type, readers dispatch on the tag to the
+// overload of a visitor matching the message's type at compile time
+template<std::uint32_t length_, bool share_cacheline, bool accept_UB, typename... MessageTypes>
+requires (sizeof...(MessageTypes) > 0) && (sizeof...(MessageTypes) <= 256) && (distinct_types<MessageTypes...>())
+   && (std::is_trivially_copyable_v<MessageTypes> && ...) && (std::is_default_constructible_v<MessageTypes> && ...) && ((!std::is_const_v<MessageTypes>) && ...)
+struct VariantSeqLockQueue {
+private:
+   using SlotType = TaggedSlot<MessageTypes...>;
+   using QueueType = SeqLockQueue<SlotType, length_, share_cacheline, accept_UB>;
+   QueueType queue;
+
+   struct QueueReader {
+   private:
+      typename QueueType::ReaderType reader;
+      template<typename Visitor, std::size_t... indices>
+      static void dispatch(const SlotType&, Visitor&, std::index_sequence<indices...>);
+
+   public:
+      explicit QueueReader(const QueueType&) noexcept;
+      ~QueueReader() = default;
+      QueueReader(const QueueReader&) = delete;
+      QueueReader& operator=(const QueueReader&) = delete;
+      QueueReader(QueueReader&&) = delete;
+      QueueReader& operator=(QueueReader&&) = delete;
+      // calls visitor with the next message if there is one, returns whether a message was read
+      template<typename Visitor>
+      requires (std::invocable<Visitor&, const MessageTypes&> && ...)
+      bool read_next_entry(Visitor&&);
+   };
+
+public:
+   static constexpr std::size_t n_types = sizeof...(MessageTypes);
+   static constexpr size_t slot_size = sizeof(SlotType);
+   static constexpr size_t element_size = QueueType::element_size;
+   explicit VariantSeqLockQueue() = default;
+   ~VariantSeqLockQueue() = default;
+   VariantSeqLockQueue(const VariantSeqLockQueue&) = delete;
+   VariantSeqLockQueue& operator=(const VariantSeqLockQueue&) = delete;
+   VariantSeqLockQueue(VariantSeqLockQueue&&) = delete;
+   VariantSeqLockQueue& operator=(VariantSeqLockQueue&&) = delete;
+   using ReaderType = QueueReader;
+   template<typename MessageType>
+   requires (std::is_same_v<MessageType, MessageTypes> || ...)
+   void enqueue(const MessageType&) noexcept;
+   QueueReader get_reader() const noexcept;
+};
+} // namespace Queue
+
+#define TEMPLATE_PARAMS                                                                            \
+   template<std::uint32_t length_, bool share_cacheline, bool accept_UB, typename... MessageTypes> \
+   requires (sizeof...(MessageTypes) > 0) && (sizeof...(MessageTypes) <= 256) && (Queue::distinct_types<MessageTypes...>()) \
+      && (std::is_trivially_copyable_v<MessageTypes> && ...) && (std::is_default_constructible_v<MessageTypes> && ...) && ((!std::is_const_v<MessageTypes>) && ...)
+
+#define VARIANT_SEQ_LOCK_QUEUE \
+   Queue::VariantSeqLockQueue<length_, share_cacheline, accept_UB, MessageTypes...>
+
+TEMPLATE_PARAMS
+template<typename MessageType>
+requires (std::is_same_v<MessageType, MessageTypes> || ...)
+void VARIANT_SEQ_LOCK_QUEUE::enqueue(const MessageType& message) noexcept {
+   SlotType slot;
+   slot.store(message);
+   this->queue.enqueue(slot);
+};
+
+TEMPLATE_PARAMS
+VARIANT_SEQ_LOCK_QUEUE::QueueReader VARIANT_SEQ_LOCK_QUEUE::get_reader() const noexcept {
+   return QueueReader(this->queue);
+};
+
+TEMPLATE_PARAMS
+VARIANT_SEQ_LOCK_QUEUE::QueueReader::QueueReader(const QueueType& queue_) noexcept
+    :
+    reader(queue_.get_reader()) {};
+
+TEMPLATE_PARAMS
+template<typename Visitor, std::size_t... indices>
+void VARIANT_SEQ_LOCK_QUEUE::QueueReader::dispatch(const SlotType& slot, Visitor& visitor, std::index_sequence<indices...>) {
+   // chain of comparisons against constants, compiled to a jump table or a few branches, no indirect calls
+   (void)((slot.tag == indices && (visitor(slot.template load<indices>()), true)) || ...);
+};
+
+TEMPLATE_PARAMS
+template<typename Visitor>
+requires (std::invocable<Visitor&, const MessageTypes&> && ...)
+bool VARIANT_SEQ_LOCK_QUEUE::QueueReader::read_next_entry(Visitor&& visitor) {
+   const auto slot = this->reader.read_next_entry();
+   if(!slot.has_value()) {
+      return false;
+   }
+   dispatch(slot.value(), visitor, std::index_sequence_for<MessageTypes...>{});
+   return true;
+};
+
+#undef TEMPLATE_PARAMS
+#undef VARIANT_SEQ_LOCK_QUEUE
@@ -0,0 +1,166 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "doctest.h"
+
+#include "BlockQueue.hpp"
+
+TEST_CASE("testing Queue::BlockSeqLockQueue") {
+  SUBCASE("testing enqueueing and dequeueing full blocks") {
+    using slqClass = Queue::BlockSeqLockQueue<int, 16, false>;
+    static_assert(slqClass::slots_per_block == 8);
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    CHECK(!testReader.read_next_entry().has_value());
+    int enqSum = 0;
+    for (int i = 0; i < 7; ++i) {
+      testSlq.enqueue(i);
+      enqSum += i;
+    };
+    // block is not published before it is full
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.enqueue(7);
+    enqSum += 7;
+    int deqSum = 0;
+    for (int i = 0; i < 8; ++i) {
+      deqSum += testReader.read_next_entry().value();
+    };
+    CHECK(enqSum == deqSum);
+    CHECK(!testReader.read_next_entry().has_value());
+  }
+
+  SUBCASE("testing publishing partially filled blocks via flush") {
+    using slqClass = Queue::BlockSeqLockQueue<int, 16, true>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    testSlq.enqueue(1);
+    testSlq.enqueue(2);
+    testSlq.flush();
+    CHECK(testReader.read_next_entry().value() == 1);
+    CHECK(testReader.read_next_entry().value() == 2);
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.enqueue(3);
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.flush();
+    CHECK(testReader.read_next_entry().value() == 3);
+    CHECK(!testReader.read_next_entry().has_value());
+  }
+
+  SUBCASE("testing flushed entries staying readable while the block is filled") {
+    using slqClass = Queue::BlockSeqLockQueue<int, 16, false>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    testSlq.enqueue(1);
+    testSlq.enqueue(2);
+    testSlq.flush();
+    // the producer continues filling the same block before the reader got to the flushed entries
+    testSlq.enqueue(3);
+    CHECK(testReader.read_next_entry().value() == 1);
+    CHECK(testReader.read_next_entry().value() == 2);
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.flush();
+    testSlq.enqueue(4);
+    CHECK(testReader.read_next_entry().value() == 3);
+    CHECK(!testReader.read_next_entry().has_value());
+    // filling the block publishes the rest of it
+    for (int i = 5; i <= static_cast<int>(slqClass::slots_per_block); ++i) {
+      testSlq.enqueue(i);
+    };
+    for (int i = 4; i <= static_cast<int>(slqClass::slots_per_block); ++i) {
+      CHECK(testReader.read_next_entry().value() == i);
+    };
+    CHECK(!testReader.read_next_entry().has_value());
+  }
+
+  SUBCASE("testing wrapping around and being overtaken by the producer") {
+    using slqClass = Queue::BlockSeqLockQueue<int, 16, false>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    for (int i = 0; i < 16; ++i) {
+      testSlq.enqueue(i);
+    };
+    for (int i = 0; i < 16; ++i) {
+      CHECK(testReader.read_next_entry().value() == i);
+    };
+    CHECK(!testReader.read_next_entry().has_value());
+    // overwrite entire buffer more than once, reader continues with the block at its current position
+    for (int i = 16; i < 56; ++i) {
+      testSlq.enqueue(i);
+    };
+    testSlq.flush();
+    for (int i = 48; i < 56; ++i) {
+      CHECK(testReader.read_next_entry().value() == i);
+    };
+    CHECK(!testReader.read_next_entry().has_value());
+  }
+
+  SUBCASE(
+      "testing for correct behavior under concurrent enqueueing and dequeueing") {
+    static constexpr std::uint32_t nElements = 524288;
+    using slqClass = Queue::BlockSeqLockQueue<int, nElements, false>;
+    slqClass testSlq;
+    std::uint64_t enqSum{0};
+    alignas(64) std::uint64_t deqSum1{0};
+    alignas(64) std::uint64_t deqSum2{0};
+    alignas(64) std::atomic_flag startSignal{false};
+
+    std::thread enqThread([&]() {
+      std::srand(std::time(nullptr));
+      int randInt{0};
+      while (!startSignal.test())
+        ;
+      for (std::uint32_t i = 0; i < nElements; ++i) {
+        randInt = std::rand();
+        testSlq.enqueue(randInt);
+        enqSum += randInt;
+      }
+      testSlq.flush();
+    });
+
+    std::thread deqThread1([&]() {
+      std::optional<int> deqRes;
+      std::uint32_t nIter{0};
+      auto testReader = testSlq.get_reader();
+      while (!startSignal.test());
+      while (nIter < nElements) {
+        deqRes = testReader.read_next_entry();
+        if (deqRes.has_value()) {
+          deqSum1 += deqRes.value();
+          ++nIter;
+        }
+      }
+    });
+
+    std::thread deqThread2([&]() {
+      std::optional<int> deqRes;
+      std::uint32_t nIter{0};
+      auto testReader = testSlq.get_reader();
+      while (!startSignal.test());
+      while (nIter < nElements) {
+        deqRes = testReader.read_next_entry();
+        if (deqRes.has_value()) {
+          deqSum2 += deqRes.value();
+          ++nIter;
+        }
+      }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    startSignal.test_and_set();
+    enqThread.join();
+    deqThread1.join();
+    deqThread2.join();
+
+    CHECK(enqSum == deqSum1);
+    CHECK(enqSum == deqSum2);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,133 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+#include "ByteQueue.hpp"
+
+// message of the given size whose bytes are derived from seed
+std::vector<std::byte> make_message(std::size_t size, std::uint32_t seed) {
+  std::vector<std::byte> message(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    message[i] = static_cast<std::byte>((seed * 31 + i) & 0xff);
+  };
+  return message;
+}
+
+bool equals(std::span<const std::byte> lhs, const std::vector<std::byte>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+TEST_CASE("testing Queue::ByteSeqLockQueue") {
+  SUBCASE("testing enqueueing and dequeueing messages of different sizes") {
+    using slqClass = Queue::ByteSeqLockQueue<64>;
+    static_assert(slqClass::slot_size == 64);
+    static_assert(slqClass::slots_for(0) == 1);
+    static_assert(slqClass::slots_for(48) == 1);
+    static_assert(slqClass::slots_for(49) == 2);
+    static_assert(slqClass::max_message_size == 32 * 56 - 8);
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    CHECK(!testReader.read_next_entry().has_value());
+    const auto small = make_message(40, 1);
+    const auto large = make_message(1000, 2);
+    const auto empty = make_message(0, 3);
+    CHECK(testSlq.enqueue(small));
+    CHECK(testSlq.enqueue(large));
+    CHECK(testSlq.enqueue(empty));
+    CHECK(equals(testReader.read_next_entry().value(), small));
+    CHECK(equals(testReader.read_next_entry().value(), large));
+    CHECK(testReader.read_next_entry().value().empty());
+    CHECK(!testReader.read_next_entry().has_value());
+    CHECK(testReader.get_overruns() == 0);
+    // messages exceeding half of the ring are rejected
+    CHECK(!testSlq.enqueue(make_message(slqClass::max_message_size + 1, 4)));
+    CHECK(testSlq.enqueue(make_message(slqClass::max_message_size, 4)));
+    CHECK(equals(testReader.read_next_entry().value(), make_message(slqClass::max_message_size, 4)));
+  }
+
+  SUBCASE("testing wrap around") {
+    using slqClass = Queue::ByteSeqLockQueue<8>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    // 3 slots each, the third message wraps around the end of the ring
+    for (std::uint32_t i = 0; i < 6; ++i) {
+      const auto message = make_message(150, i);
+      CHECK(testSlq.enqueue(message));
+      CHECK(equals(testReader.read_next_entry().value(), message));
+    };
+    CHECK(!testReader.read_next_entry().has_value());
+    CHECK(testReader.get_overruns() == 0);
+  }
+
+  SUBCASE("testing overrun detection and resynchronization") {
+    using slqClass = Queue::ByteSeqLockQueue<8>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    for (std::uint32_t i = 0; i < 5; ++i) {
+      testSlq.enqueue(make_message(100, i));
+    };
+    // first message has been overwritten, the reader skips to the producer's position
+    CHECK(!testReader.read_next_entry().has_value());
+    CHECK(testReader.get_overruns() == 1);
+    CHECK(!testReader.read_next_entry().has_value());
+    const auto message = make_message(20, 9);
+    testSlq.enqueue(message);
+    CHECK(equals(testReader.read_next_entry().value(), message));
+    CHECK(testReader.get_overruns() == 1);
+  }
+
+  SUBCASE("testing concurrent enqueueing and dequeueing") {
+    using slqClass = Queue::ByteSeqLockQueue<1024>;
+    slqClass testSlq;
+    constexpr std::uint32_t nMessages = 2000;
+    std::atomic<bool> readerReady = false;
+    std::atomic<bool> done = false;
+    std::uint32_t nRead = 0;
+    std::uint32_t nCorrupted = 0;
+    std::jthread readerThread([&]() {
+      auto testReader = testSlq.get_reader();
+      readerReady.store(true);
+      while (true) {
+        // entries enqueued before done was set are read before stopping
+        const bool finished = done.load();
+        const auto entry = testReader.read_next_entry();
+        if (!entry.has_value()) {
+          if (finished) {
+            break;
+          }
+          continue;
+        }
+        // message size identifies the seed, contents must never be torn
+        const std::size_t size = entry.value().size();
+        const std::uint32_t seed = static_cast<std::uint32_t>(size == 40 ? 0 : size - 2000);
+        nCorrupted += !equals(entry.value(), make_message(size, seed));
+        ++nRead;
+      };
+    });
+    while (!readerReady.load()) {
+    };
+    for (std::uint32_t i = 0; i < nMessages; ++i) {
+      testSlq.enqueue(i % 2 == 0 ? make_message(40, 0) : make_message(2000 + i % 64, i % 64));
+      if (i % 16 == 0) {
+        std::this_thread::yield();
+      }
+    };
+    done.store(true);
+    readerThread.join();
+    CHECK(nCorrupted == 0);
+    CHECK(nRead > 0);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
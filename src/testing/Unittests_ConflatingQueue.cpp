@@ -0,0 +1,134 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "ConflatingQueue.hpp"
+
+#include "doctest.h"
+
+struct Quote {
+  std::int64_t price = 0;
+  std::int64_t size = 0;
+};
+
+TEST_CASE("testing Queue::ConflatingQueue") {
+  SUBCASE("testing conflation of pending keys") {
+    using queueClass = Queue::ConflatingQueue<Quote, 1000, 2, false>;
+    static_assert(queueClass::key_ring_length == 1024);
+    queueClass testQueue;
+    auto firstReader = testQueue.get_reader();
+    auto secondReader = testQueue.get_reader();
+    CHECK(firstReader.is_attached());
+    CHECK(secondReader.is_attached());
+    CHECK(!testQueue.get_reader().is_attached());
+    CHECK(!firstReader.read_next_entry().has_value());
+    for (std::int64_t i = 1; i <= 1000; ++i) {
+      testQueue.enqueue(7, {i, 2 * i});
+    };
+    testQueue.enqueue(999, {5, 10});
+    testQueue.enqueue(7, {1001, 2002});
+    // a key updated 1001 times while the reader was busy is read once, with its latest value, in the order in which
+    // keys first became pending
+    auto update = firstReader.read_next_entry();
+    CHECK(update.has_value());
+    CHECK(update->key == 7);
+    CHECK(update->value.price == 1001);
+    update = firstReader.read_next_entry();
+    CHECK(update->key == 999);
+    CHECK(update->value.price == 5);
+    CHECK(!firstReader.read_next_entry().has_value());
+    // a key read already becomes pending again with its next store
+    testQueue.enqueue(7, {1002, 2004});
+    CHECK(firstReader.read_next_entry()->value.price == 1002);
+    CHECK(!firstReader.read_next_entry().has_value());
+    // every reader has pending keys of its own
+    CHECK(secondReader.read_next_entry()->key == 7);
+    CHECK(secondReader.read_next_entry()->key == 999);
+    CHECK(!secondReader.read_next_entry().has_value());
+    CHECK(testQueue.load(7).size == 2004);
+  }
+
+  SUBCASE("testing backlog bounded by the number of keys") {
+    using queueClass = Queue::ConflatingQueue<int, 64, 1, true>;
+    queueClass testQueue;
+    auto reader = testQueue.get_reader();
+    // far more stores than the ring holds, every key stays pending once
+    for (int i = 0; i < 10000; ++i) {
+      testQueue.enqueue(static_cast<std::uint32_t>(i % 64), i);
+    };
+    std::uint32_t nRead = 0;
+    while (const auto update = reader.read_next_entry()) {
+      CHECK(update->key == nRead);
+      // last of the values stored to the key
+      CHECK(update->value == 9999 - (9999 - static_cast<int>(nRead)) % 64);
+      ++nRead;
+    };
+    CHECK(nRead == 64);
+  }
+
+  SUBCASE("testing reattaching") {
+    using queueClass = Queue::ConflatingQueue<int, 100, 1, true>;
+    queueClass testQueue;
+    {
+      auto reader = testQueue.get_reader();
+      testQueue.enqueue(5, 1);
+    }
+    testQueue.enqueue(6, 2);
+    // a new reader neither sees keys left pending by its predecessor nor those stored while no reader was attached
+    auto reader = testQueue.get_reader();
+    CHECK(reader.is_attached());
+    CHECK(!reader.read_next_entry().has_value());
+    testQueue.enqueue(5, 3);
+    const auto update = reader.read_next_entry();
+    CHECK((update->key == 5 && update->value == 3));
+    CHECK(!reader.read_next_entry().has_value());
+  }
+
+  SUBCASE("testing concurrent enqueueing and reading") {
+    using queueClass = Queue::ConflatingQueue<Quote, 512, 1, false>;
+    queueClass testQueue;
+    constexpr std::int64_t nRounds = 500;
+    std::atomic<bool> readerReady = false;
+    std::atomic<bool> done = false;
+    std::vector<std::int64_t> latest(512, 0);
+    std::uint64_t nInconsistent = 0;
+    std::jthread readerThread([&]() {
+      auto reader = testQueue.get_reader();
+      readerReady.store(true);
+      const auto check = [&](const queueClass::UpdateType& update) {
+        nInconsistent += update.value.size != update.value.price * 2 || update.value.price < latest[update.key];
+        latest[update.key] = update.value.price;
+      };
+      while (!done.load()) {
+        if (const auto update = reader.read_next_entry()) {
+          check(update.value());
+        };
+      };
+      while (const auto update = reader.read_next_entry()) {
+        check(update.value());
+      };
+    });
+    while (!readerReady.load()) {
+    };
+    for (std::int64_t round = 1; round <= nRounds; ++round) {
+      for (std::uint32_t key = 0; key < 512; key += 1 + round % 5) {
+        testQueue.enqueue(key, {round, 2 * round});
+      };
+    };
+    done.store(true);
+    readerThread.join();
+    CHECK(nInconsistent == 0);
+    // no key is left pending, every key's final value has been seen
+    for (std::uint32_t key = 0; key < 512; ++key) {
+      CHECK(latest[key] == testQueue.load(key).price);
+    };
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "LastValueCache.hpp"
+
+#include "doctest.h"
+
+struct Quote {
+  std::int64_t price = 0;
+  std::int64_t size = 0;
+};
+
+TEST_CASE("testing Cache::DirtyBitmap") {
+  Cache::DirtyBitmap<5000> bitmap;
+  static_assert(Cache::DirtyBitmap<5000>::n_words == 79);
+  static_assert(Cache::DirtyBitmap<5000>::n_summary_words == 2);
+  for (std::uint32_t key : {4999u, 3u, 64u, 3u, 4095u, 4096u}) {
+    bitmap.mark(key);
+  };
+  std::vector<std::uint32_t> drained;
+  CHECK(bitmap.drain([&drained](std::uint32_t key) { drained.push_back(key); }) == 5);
+  CHECK(drained == std::vector<std::uint32_t>{3, 64, 4095, 4096, 4999});
+  CHECK(bitmap.drain([](std::uint32_t) {}) == 0);
+}
+
+TEST_CASE("testing Cache::LastValueCache") {
+  SUBCASE("testing store, load and changed keys") {
+    using cacheClass = Cache::LastValueCache<Quote, 50000, 2, false>;
+    cacheClass testCache;
+    auto firstReader = testCache.get_reader();
+    auto secondReader = testCache.get_reader();
+    CHECK(firstReader.is_attached());
+    CHECK(secondReader.is_attached());
+    CHECK(!testCache.get_reader().is_attached());
+    CHECK(testCache.load(17).price == 0);
+    testCache.store(17, {100, 1});
+    testCache.store(49999, {200, 2});
+    testCache.store(17, {101, 3});
+    CHECK(testCache.load(17).price == 101);
+    std::vector<std::uint32_t> keys;
+    std::int64_t sum = 0;
+    // a key stored several times is visited once with its latest value
+    CHECK(firstReader.for_each_changed([&](std::uint32_t key, const Quote& quote) {
+      keys.push_back(key);
+      sum += quote.price;
+    }) == 2);
+    CHECK(keys == std::vector<std::uint32_t>{17, 49999});
+    CHECK(sum == 301);
+    CHECK(firstReader.for_each_changed([](std::uint32_t, const Quote&) {}) == 0);
+    // every reader has a bitmap of its own
+    CHECK(secondReader.for_each_changed([](std::uint32_t, const Quote&) {}) == 2);
+  }
+
+  SUBCASE("testing reattaching") {
+    using cacheClass = Cache::LastValueCache<int, 100, 1, true>;
+    cacheClass testCache;
+    {
+      auto reader = testCache.get_reader();
+      CHECK(reader.is_attached());
+    }
+    testCache.store(5, 1);
+    // a new reader only sees changes made after it attached
+    auto reader = testCache.get_reader();
+    CHECK(reader.is_attached());
+    CHECK(reader.for_each_changed([](std::uint32_t, int) {}) == 0);
+    testCache.store(6, 2);
+    CHECK(reader.for_each_changed([](std::uint32_t key, int value) { CHECK((key == 6 && value == 2)); }) == 1);
+  }
+
+  SUBCASE("testing concurrent stores and scans") {
+    using cacheClass = Cache::LastValueCache<Quote, 4096, 1, false>;
+    cacheClass testCache;
+    constexpr std::int64_t nRounds = 200;
+    std::atomic<bool> readerReady = false;
+    std::atomic<bool> done = false;
+    std::vector<std::int64_t> latest(4096, 0);
+    std::uint64_t nInconsistent = 0;
+    std::jthread readerThread([&]() {
+      auto reader = testCache.get_reader();
+      readerReady.store(true);
+      const auto visit = [&](std::uint32_t key, const Quote& quote) {
+        nInconsistent += quote.size != quote.price * 2 || quote.price < latest[key];
+        latest[key] = quote.price;
+      };
+      while (!done.load()) {
+        reader.for_each_changed(visit);
+      };
+      reader.for_each_changed(visit);
+    });
+    while (!readerReady.load()) {
+    };
+    for (std::int64_t round = 1; round <= nRounds; ++round) {
+      for (std::uint32_t key = 0; key < 4096; key += 1 + round % 7) {
+        testCache.store(key, {round, 2 * round});
+      };
+    };
+    done.store(true);
+    readerThread.join();
+    CHECK(nInconsistent == 0);
+    // every key's final value has been seen
+    for (std::uint32_t key = 0; key < 4096; ++key) {
+      CHECK(latest[key] == testCache.load(key).price);
+    };
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
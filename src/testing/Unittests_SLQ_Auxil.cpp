@@ -35,6 +35,10 @@ TEST_CASE("testing SLQ_Auxil"){
         test_atomic_arr_copy_2 = test_atomic_arr_copy_1;
         CHECK(static_cast<TestTuple>(test_atomic_arr_copy_1) == test_tuple);
         CHECK(static_cast<TestTuple>(test_atomic_arr_copy_2) == test_tuple);
+        TestAtomicArrCopy test_atomic_arr_copy_3;
+        test_atomic_arr_copy_3.copy_chunk(test_atomic_arr_copy_1, 0, 16);
+        test_atomic_arr_copy_3.copy_chunk(test_atomic_arr_copy_1, 16, sizeof(TestTuple) - 16);
+        CHECK(static_cast<TestTuple>(test_atomic_arr_copy_3) == test_tuple);
     };
 
     SUBCASE("testing SLQ_Auxil::atomic_arr_copy_standin"){
@@ -44,9 +48,28 @@ TEST_CASE("testing SLQ_Auxil"){
         test_atomic_arr_copy_2 = test_atomic_arr_copy_1;
         CHECK(static_cast<TestTuple>(test_atomic_arr_copy_1) == test_tuple);
         CHECK(static_cast<TestTuple>(test_atomic_arr_copy_2) == test_tuple);
+        TestAtomicArrCopyStandin test_atomic_arr_copy_3;
+        test_atomic_arr_copy_3.copy_chunk(test_atomic_arr_copy_1, 0, 16);
+        test_atomic_arr_copy_3.copy_chunk(test_atomic_arr_copy_1, 16, sizeof(TestTuple) - 16);
+        CHECK(static_cast<TestTuple>(test_atomic_arr_copy_3) == test_tuple);
     };
 };
 
+TEST_CASE("testing SLQ_Auxil alignment helpers"){
+    CHECK(SLQ_Auxil::ceil_(72u, 64u) == 128u);
+    CHECK(SLQ_Auxil::ceil_(64u, 64u) == 64u);
+    CHECK(SLQ_Auxil::divisible_(24u, 64u) == 32u);
+    CHECK(SLQ_Auxil::divisible_or_ceil(8u, 64u) == 8u);
+    CHECK(SLQ_Auxil::divisible_or_ceil(24u, 64u) == 32u);
+    CHECK(SLQ_Auxil::divisible_or_ceil(64u, 64u) == 64u);
+    CHECK(SLQ_Auxil::divisible_or_ceil(72u, 64u) == 128u);
+    CHECK(SLQ_Auxil::max_lines_spanned(16u, 64u) == 1u);
+    CHECK(SLQ_Auxil::max_lines_spanned(24u, 64u) == 2u);
+    CHECK(SLQ_Auxil::max_lines_spanned(64u, 64u) == 1u);
+    CHECK(SLQ_Auxil::max_lines_spanned(112u, 64u) == 3u);
+    CHECK(SLQ_Auxil::max_lines_spanned(128u, 64u) == 2u);
+};
+
 int main() {
   doctest::Context context;
   context.run();
@@ -0,0 +1,96 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+#include "Cell.hpp"
+
+#include "doctest.h"
+
+// every element holds the same value, a torn copy would mix values of different stores
+struct Snapshot {
+  std::array<std::uint64_t, 32> values;
+  bool consistent() const noexcept {
+    for (std::uint64_t value : values) {
+      if (value != values[0]) {
+        return false;
+      }
+    };
+    return true;
+  };
+};
+
+TEST_CASE("testing Cell::SeqLockCell") {
+  SUBCASE("testing store, load and load_if_changed") {
+    using cellClass = Cell::SeqLockCell<int, false>;
+    static_assert(alignof(cellClass) == 64);
+    cellClass testCell;
+    std::int64_t lastVersion = cellClass::initial_version;
+    CHECK(testCell.load() == 0);
+    CHECK(!testCell.load_if_changed(lastVersion).has_value());
+    testCell.store(5);
+    CHECK(testCell.load() == 5);
+    CHECK(testCell.load_if_changed(lastVersion).value() == 5);
+    CHECK(lastVersion == testCell.version());
+    CHECK(!testCell.load_if_changed(lastVersion).has_value());
+    testCell.store(6);
+    testCell.store(7);
+    // only the latest value is returned
+    CHECK(testCell.load_if_changed(lastVersion).value() == 7);
+    CHECK(!testCell.load_if_changed(lastVersion).has_value());
+  }
+
+  SUBCASE("testing double buffered cell") {
+    using cellClass = Cell::SeqLockCell<int, true, true>;
+    cellClass testCell;
+    std::int64_t lastVersion = cellClass::initial_version;
+    CHECK(!testCell.load_if_changed(lastVersion).has_value());
+    testCell.store(1);
+    CHECK(testCell.load_if_changed(lastVersion).value() == 1);
+    testCell.store(2);
+    CHECK(testCell.load() == 2);
+    CHECK(testCell.load_if_changed(lastVersion).value() == 2);
+    CHECK(!testCell.load_if_changed(lastVersion).has_value());
+  }
+
+  SUBCASE("testing concurrent stores and loads") {
+    using cellClass = Cell::SeqLockCell<Snapshot, false>;
+    cellClass testCell;
+    constexpr std::uint64_t nStores = 20000;
+    std::atomic<bool> readerReady = false;
+    std::uint64_t nInconsistent = 0;
+    std::uint64_t nDecreasing = 0;
+    std::jthread readerThread([&]() {
+      std::int64_t lastVersion = cellClass::initial_version;
+      std::uint64_t lastValue = 0;
+      readerReady.store(true);
+      while (lastValue != nStores) {
+        const auto loaded = testCell.load_if_changed(lastVersion);
+        if (!loaded.has_value()) {
+          continue;
+        }
+        nInconsistent += !loaded->consistent();
+        nDecreasing += loaded->values[0] <= lastValue;
+        lastValue = loaded->values[0];
+      };
+    });
+    while (!readerReady.load()) {
+    };
+    Snapshot snapshot;
+    for (std::uint64_t i = 1; i <= nStores; ++i) {
+      snapshot.values.fill(i);
+      testCell.store(snapshot);
+    };
+    readerThread.join();
+    CHECK(nInconsistent == 0);
+    CHECK(nDecreasing == 0);
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
@@ -1,6 +1,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <optional>
+#include <thread>
 #include <tuple>
 
 #include "Element.hpp"
@@ -15,6 +19,13 @@ TEST_CASE("testing SeqLockElement::SeqLockElement with undefined behavior throug
   auto readRet = testElement.read(1);
   CHECK(std::get<0>(readRet).value() == 123);
   CHECK(std::get<1>(readRet) == 2);
+  CHECK(std::get<0>(testElement.try_read(1, 1)).value() == 123);
+  CHECK(!std::get<0>(testElement.try_read(3, 1)).has_value());
+  // simulate a writer that never completes its write, bounded reads give up
+  testElement.version.store(3);
+  readRet = testElement.try_read(0, 1000);
+  CHECK(!std::get<0>(readRet).has_value());
+  CHECK(std::get<1>(readRet) == 3);
 }
 
 TEST_CASE("testing SeqLockElement::SeqLockElement eliminating undefined behavior") {
@@ -27,6 +38,168 @@ TEST_CASE("testing SeqLockElement::SeqLockElement eliminating undefined behavior
   CHECK(std::get<1>(readRet) == 2);
 }
 
+// payload spanning multiple cachelines, every word is derived from the same sequence number so torn reads can be detected
+template <std::size_t nWords>
+struct ChecksumPayload {
+  std::array<std::uint64_t, nWords - 1> words;
+  std::uint64_t checksum;
+  explicit ChecksumPayload(std::uint64_t seq = 0) noexcept {
+    checksum = 0;
+    for (std::uint64_t i = 0; i < words.size(); ++i) {
+      words[i] = seq * 31 + i;
+      checksum ^= words[i];
+    }
+  };
+  bool intact() const noexcept {
+    std::uint64_t check = 0;
+    for (std::uint64_t i = 0; i < words.size(); ++i) {
+      check ^= words[i];
+    }
+    return check == checksum && words[words.size() - 1] - words[0] == words.size() - 1;
+  };
+};
+
+// litmus test: one thread inserts continuously while several threads read, every successful read needs to be intact and
+// neither sequence numbers nor versions may ever go backwards for a single reader
+template <typename testElementClass, std::uint64_t nInserts = 1 << 18>
+void torn_read_stress() {
+  using PayloadType = testElementClass::PayloadType;
+  static constexpr int nReaders = 3;
+  testElementClass testElement;
+  std::atomic_flag startSignal{false};
+  std::atomic<bool> writerDone{false};
+  std::array<std::uint64_t, nReaders> tornReads{};
+  std::array<std::uint64_t, nReaders> reorderedReads{};
+
+  std::thread writerThread([&]() {
+    while (!startSignal.test());
+    for (std::uint64_t i = 1; i <= nInserts; ++i) {
+      testElement.insert(PayloadType(i));
+    }
+    writerDone.store(true, std::memory_order_release);
+  });
+
+  std::array<std::thread, nReaders> readerThreads;
+  for (int r = 0; r < nReaders; ++r) {
+    readerThreads[r] = std::thread([&, r]() {
+      std::int64_t lastVersion = 0;
+      std::uint64_t lastSeq = 0;
+      while (!startSignal.test());
+      while (!writerDone.load(std::memory_order_acquire)) {
+        const auto [readOpt, readVersion] = testElement.read(0);
+        const PayloadType& payload = readOpt.value();
+        tornReads[r] += !payload.intact();
+        const std::uint64_t seq = payload.words[0] / 31;
+        reorderedReads[r] += readVersion < lastVersion || seq < lastSeq || readVersion != 2 * static_cast<std::int64_t>(seq);
+        lastVersion = readVersion;
+        lastSeq = seq;
+      }
+    });
+  }
+
+  startSignal.test_and_set();
+  writerThread.join();
+  for (auto& t : readerThreads) {
+    t.join();
+  }
+  for (int r = 0; r < nReaders; ++r) {
+    CHECK(tornReads[r] == 0);
+    CHECK(reorderedReads[r] == 0);
+  }
+  const auto finalRead = testElement.read(0);
+  CHECK(std::get<0>(finalRead).value().intact());
+  CHECK(std::get<1>(finalRead) == 2 * nInserts);
+}
+
+TEST_CASE("litmus testing SeqLockElement for torn reads with undefined behavior through data-race") {
+  torn_read_stress<Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_standin<ChecksumPayload<16>>, 64>>();
+}
+
+TEST_CASE("litmus testing SeqLockElement for torn reads eliminating undefined behavior") {
+  torn_read_stress<Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_t<ChecksumPayload<16>>, 64>>();
+}
+
+TEST_CASE("testing SeqLockElement with chunked reads of large payloads") {
+  using standinElementClass = Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_standin<ChecksumPayload<512>>, 64>;
+  using atomicElementClass = Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_t<ChecksumPayload<512>>, 64>;
+  static_assert(!Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_t<ChecksumPayload<16>>, 64>::chunked_read);
+  static_assert(standinElementClass::chunked_read && atomicElementClass::chunked_read);
+  SUBCASE("with undefined behavior through data-race") {
+    standinElementClass testElement;
+    CHECK(!std::get<0>(testElement.read(1)).has_value());
+    testElement.insert(ChecksumPayload<512>(123));
+    auto readRet = testElement.read(1);
+    CHECK(std::get<0>(readRet).value().intact());
+    CHECK(std::get<0>(readRet).value().words[0] == 123 * 31);
+    CHECK(std::get<1>(readRet) == 2);
+  }
+  SUBCASE("eliminating undefined behavior") {
+    atomicElementClass testElement;
+    CHECK(!std::get<0>(testElement.read(1)).has_value());
+    testElement.insert(ChecksumPayload<512>(123));
+    auto readRet = testElement.read(1);
+    CHECK(std::get<0>(readRet).value().intact());
+    CHECK(std::get<0>(readRet).value().words[0] == 123 * 31);
+    CHECK(std::get<1>(readRet) == 2);
+  }
+}
+
+TEST_CASE("litmus testing SeqLockElement with chunked reads for torn reads with undefined behavior through data-race") {
+  torn_read_stress<Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_standin<ChecksumPayload<512>>, 64>, 1 << 14>();
+}
+
+TEST_CASE("litmus testing SeqLockElement with chunked reads for torn reads eliminating undefined behavior") {
+  torn_read_stress<Element::SeqLockElement<SLQ_Auxil::atomic_arr_copy_t<ChecksumPayload<512>>, 64>, 1 << 14>();
+}
+
+TEST_CASE("testing DoubleBufferedElement") {
+  SUBCASE("with undefined behavior through data-race") {
+    using testElementClass = Element::DoubleBufferedElement<SLQ_Auxil::atomic_arr_copy_standin<std::uint8_t>, 8>;
+    testElementClass testElement;
+    CHECK(!std::get<0>(testElement.read(1)).has_value());
+    testElement.insert(123);
+    auto readRet = testElement.read(1);
+    CHECK(std::get<0>(readRet).value() == 123);
+    CHECK(std::get<1>(readRet) == 2);
+    testElement.insert(45);
+    readRet = testElement.read(3);
+    CHECK(std::get<0>(readRet).value() == 45);
+    CHECK(std::get<1>(readRet) == 4);
+  }
+  SUBCASE("eliminating undefined behavior") {
+    using testElementClass = Element::DoubleBufferedElement<SLQ_Auxil::atomic_arr_copy_t<std::uint8_t>, 8>;
+    testElementClass testElement;
+    CHECK(!std::get<0>(testElement.read(1)).has_value());
+    testElement.insert(123);
+    auto readRet = testElement.read(1);
+    CHECK(std::get<0>(readRet).value() == 123);
+    CHECK(std::get<1>(readRet) == 2);
+    testElement.insert(45);
+    readRet = testElement.read(3);
+    CHECK(std::get<0>(readRet).value() == 45);
+    CHECK(std::get<1>(readRet) == 4);
+  }
+  SUBCASE("reading while a write is in progress") {
+    using testElementClass = Element::DoubleBufferedElement<SLQ_Auxil::atomic_arr_copy_t<std::uint8_t>, 8>;
+    testElementClass testElement;
+    testElement.insert(123);
+    // simulate a write that has started but not completed yet, read must return the previous content without spinning
+    testElement.version.store(3);
+    auto readRet = testElement.read(1);
+    CHECK(std::get<0>(readRet).value() == 123);
+    CHECK(std::get<1>(readRet) == 2);
+    CHECK(!std::get<0>(testElement.read(3)).has_value());
+  }
+}
+
+TEST_CASE("litmus testing DoubleBufferedElement for torn reads with undefined behavior through data-race") {
+  torn_read_stress<Element::DoubleBufferedElement<SLQ_Auxil::atomic_arr_copy_standin<ChecksumPayload<16>>, 64>>();
+}
+
+TEST_CASE("litmus testing DoubleBufferedElement for torn reads eliminating undefined behavior") {
+  torn_read_stress<Element::DoubleBufferedElement<SLQ_Auxil::atomic_arr_copy_t<ChecksumPayload<16>>, 64>>();
+}
+
 int main() {
   doctest::Context context;
   context.run();
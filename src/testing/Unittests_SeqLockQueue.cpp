@@ -1,13 +1,19 @@
 #define DOCTEST_CONFIG_IMPLEMENT
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
+#include <span>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 
 #include "doctest.h"
 
 #include "Queue.hpp"
+#include "Telemetry.hpp"
 
 struct test_class_12bytes{
   int i1;
@@ -299,6 +305,309 @@ SUBCASE(
     CHECK(enqSum == deqSum1);
     CHECK(enqSum == deqSum2);
 }
+
+SUBCASE("testing enqueueing and dequeueing with double buffered elements") {
+    using slqClass = Queue::SeqLockQueue<int, 4, true, false, true>;
+    slqClass testSlq{};
+    auto testReader = testSlq.get_reader();
+    CHECK(!testReader.read_next_entry().has_value());
+    int enqSum = 0;
+    for (int i = 0; i < 4; ++i) {
+      testSlq.enqueue(i);
+      enqSum += i;
+    };
+    auto deqRes = testReader.read_next_entry();
+    CHECK(deqRes.value() == 0);
+    int deqSum = 0;
+    for (int i = 0; i < 3; ++i) {
+      deqSum += testReader.read_next_entry().value();
+    };
+    CHECK(enqSum == deqSum);
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.enqueue(123);
+    CHECK(testReader.read_next_entry().value() == 123);
+  }
+
+SUBCASE(
+      "testing for correct behavior under concurrent enqueueing and dequeueing with double buffered elements") {
+    static constexpr std::uint32_t nElements = 524288;
+    using slqClass = Queue::SeqLockQueue<test_class_12bytes, nElements, true, false, true>;
+    slqClass testSlq;
+    std::uint64_t enqSum{0};
+    alignas(64) std::uint64_t deqSum1{0};
+    alignas(64) std::uint64_t deqSum2{0};
+    alignas(64) std::atomic_flag startSignal{false};
+
+    std::thread enqThread([&]() {
+      std::srand(std::time(nullptr));
+      while (!startSignal.test())
+        ;
+      for (std::uint32_t i = 0; i < nElements; ++i) {
+        const test_class_12bytes randObject;
+        testSlq.enqueue(randObject);
+        enqSum += randObject.get_sum();
+      }
+    });
+
+    std::thread deqThread1([&]() {
+      std::optional<test_class_12bytes> deqRes;
+      std::uint32_t nIter{0};
+      auto testReader = testSlq.get_reader();
+      while (!startSignal.test());
+      while (nIter < nElements) {
+        deqRes = testReader.read_next_entry();
+        if (deqRes.has_value()) {
+          deqSum1 += deqRes.value().get_sum();
+          ++nIter;
+        }
+      }
+    });
+
+    std::thread deqThread2([&]() {
+      std::optional<test_class_12bytes> deqRes;
+      std::uint32_t nIter{0};
+      auto testReader = testSlq.get_reader();
+      while (!startSignal.test());
+      while (nIter < nElements) {
+        deqRes = testReader.read_next_entry();
+        if (deqRes.has_value()) {
+          deqSum2 += deqRes.value().get_sum();
+          ++nIter;
+        }
+      }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    startSignal.test_and_set();
+    enqThread.join();
+    deqThread1.join();
+    deqThread2.join();
+
+    CHECK(enqSum == deqSum1);
+    CHECK(enqSum == deqSum2);
+}
+
+SUBCASE("testing enqueueing and dequeueing with producer-side prefetching") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false, false, 4>;
+    slqClass testSlq{};
+    auto testReader = testSlq.get_reader();
+    int enqSum = 0;
+    for (int i = 0; i < 8; ++i) {
+      testSlq.enqueue(i);
+      enqSum += i;
+    };
+    int deqSum = 0;
+    for (int i = 0; i < 8; ++i) {
+      deqSum += testReader.read_next_entry().value();
+    };
+    CHECK(enqSum == deqSum);
+    CHECK(!testReader.read_next_entry().has_value());
+    testSlq.enqueue(123);
+    CHECK(testReader.read_next_entry().value() == 123);
+  }
+
+SUBCASE("testing batched dequeueing") {
+    using slqClass = Queue::SeqLockQueue<int, 16, true, false>;
+    slqClass testSlq{};
+    auto testReader = testSlq.get_reader();
+    std::array<int, 8> batch;
+    CHECK(testReader.read_next_entries(batch) == 0);
+    for (int i = 0; i < 12; ++i) {
+      testSlq.enqueue(i);
+    };
+    CHECK(testReader.read_next_entries(batch) == 8);
+    CHECK(batch[0] == 0);
+    CHECK(batch[7] == 7);
+    CHECK(testReader.read_next_entries<2>(batch) == 4);
+    CHECK(batch[3] == 11);
+    CHECK(testReader.read_next_entries<0>(batch) == 0);
+    testSlq.enqueue(123);
+    CHECK(testReader.read_next_entry().value() == 123);
+  }
+
+SUBCASE("testing reader starting at the producer's position") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false>;
+    slqClass testSlq{};
+    for (int i = 0; i < 13; ++i) {
+      testSlq.enqueue(i);
+    };
+    auto testReader = testSlq.get_reader_at_producer();
+    // neither the entries of the current lap nor those left from the previous one are read
+    CHECK(!testReader.read_next_entry().has_value());
+    for (int i = 13; i < 25; ++i) {
+      testSlq.enqueue(i);
+      CHECK(testReader.read_next_entry().value() == i);
+      CHECK(!testReader.read_next_entry().has_value());
+    };
+  }
+
+SUBCASE("testing statistics") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false, false, 0, true>;
+    slqClass testSlq{};
+    auto testReader = testSlq.get_reader();
+    CHECK(!testReader.read_next_entry().has_value());
+    for (int i = 0; i < 16; ++i) {
+      testSlq.enqueue(i);
+    };
+    // the producer lapped the reader once, entries 0 to 7 were overwritten before it got to them
+    CHECK(testReader.read_next_entry().value() == 8);
+    CHECK(testReader.read_next_entry().value() == 9);
+    const auto readerStats = testReader.get_stats();
+    CHECK(readerStats.messages_read == 2);
+    CHECK(readerStats.empty_polls == 1);
+    CHECK(readerStats.overruns == 8);
+    CHECK(readerStats.retries == 0);
+    CHECK(readerStats.spin_iterations == 0);
+    CHECK(testSlq.get_producer_stats().messages_written == 16);
+    // statistics disabled: no storage and nothing counted
+    using plainClass = Queue::SeqLockQueue<int, 8, true, false>;
+    plainClass plainSlq{};
+    auto plainReader = plainSlq.get_reader();
+    plainSlq.enqueue(1);
+    CHECK(plainReader.read_next_entry().value() == 1);
+    CHECK(plainReader.get_stats().messages_read == 0);
+    // named readers disabled as well: no registry slot either
+    CHECK(sizeof(plainClass::ReaderType) == sizeof(void*) + 2 * sizeof(std::int64_t));
+    CHECK(std::is_trivially_destructible_v<plainClass::ReaderType>);
+    CHECK(!plainReader.is_registered());
+    std::array<Registry::ReaderLag, 1> lags;
+    CHECK(plainSlq.sample_reader_lags(lags) == 0);
+  }
+
+SUBCASE("testing reader registry") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false, false, 0, false, 0, true>;
+    slqClass testSlq{};
+    std::array<Registry::ReaderLag, 4> lags;
+    auto fastReader = testSlq.get_reader("fast");
+    auto anonymousReader = testSlq.get_reader();
+    CHECK(fastReader.is_registered());
+    CHECK(!anonymousReader.is_registered());
+    {
+      auto slowReader = testSlq.get_reader("slow");
+      for (int i = 0; i < 6; ++i) {
+        testSlq.enqueue(i);
+      };
+      for (int i = 0; i < 5; ++i) {
+        fastReader.read_next_entry();
+      };
+      slowReader.read_next_entry();
+      CHECK(testSlq.get_producer_position() == 6);
+      CHECK(testSlq.sample_reader_lags(lags) == 2);
+      CHECK(std::string_view(lags[0].name.data()) == "fast");
+      CHECK(lags[0].position == 5);
+      CHECK(lags[0].lag == 1);
+      CHECK(std::string_view(lags[1].name.data()) == "slow");
+      CHECK(lags[1].lag == 5);
+    }
+    // slot of a destroyed reader is released
+    CHECK(testSlq.sample_reader_lags(lags) == 1);
+    CHECK(testSlq.sample_reader_lags(std::span(lags).first(0)) == 0);
+  }
+
+SUBCASE("testing telemetry page") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false, false, 0, true, 0, true>;
+    slqClass testSlq{};
+    const std::string segmentName = "slq_unittest_" + std::to_string(::getpid());
+    CHECK(!Telemetry::Monitor(segmentName).is_open());
+    Telemetry::Publisher publisher(segmentName);
+    REQUIRE(publisher.is_open());
+    Telemetry::Monitor monitor(segmentName);
+    REQUIRE(monitor.is_open());
+    CHECK(monitor.read().value().published_ns == 0);
+    auto namedReader = testSlq.get_reader("named");
+    auto anonymousReader = testSlq.get_reader();
+    for (int i = 0; i < 12; ++i) {
+      testSlq.enqueue(i);
+    };
+    // the producer lapped the readers, entries 0 to 7 were overwritten before they got to them
+    CHECK(namedReader.read_next_entry().value() == 8);
+    CHECK(anonymousReader.read_next_entry().value() == 8);
+    CHECK(namedReader.get_stats().overruns == 8);
+    publisher.publish(testSlq);
+    const auto snapshot = monitor.read().value();
+    CHECK(snapshot.published_ns > 0);
+    CHECK(snapshot.queue_capacity == 8);
+    CHECK(snapshot.producer_position == 12);
+    CHECK(snapshot.producer_stats.messages_written == 12);
+    REQUIRE(snapshot.n_readers == 1);
+    CHECK(std::string_view(snapshot.readers[0].name.data()) == "named");
+    // a lapped reader's lag exceeds the capacity
+    CHECK(snapshot.readers[0].lag == 11);
+    CHECK(snapshot.readers[0].stats.messages_read == 1);
+    CHECK(snapshot.readers[0].stats.overruns == 8);
+    // a publisher that died mid-publish leaves an odd version behind, the monitor gives up instead of spinning forever
+    const int fd = ::shm_open(Telemetry::object_name(segmentName).c_str(), O_RDWR, 0);
+    REQUIRE(fd >= 0);
+    void* const mapping = ::mmap(nullptr, sizeof(Telemetry::Page), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    REQUIRE(mapping != MAP_FAILED);
+    Telemetry::Page* const page = static_cast<Telemetry::Page*>(mapping);
+    page->snapshot.version.fetch_add(1);
+    CHECK(!monitor.read().has_value());
+    page->snapshot.version.fetch_add(1);
+    CHECK(monitor.read().value().producer_position == 12);
+    ::munmap(mapping, sizeof(Telemetry::Page));
+  }
+
+SUBCASE("testing enqueue timestamps") {
+    using slqClass = Queue::SeqLockQueue<int, 8, true, false, false, 0, false, 2>;
+    slqClass testSlq{};
+    auto testReader = testSlq.get_reader();
+    CHECK(!testReader.last_enqueue_timestamp().has_value());
+    for (int i = 0; i < 4; ++i) {
+      testSlq.enqueue(i);
+    };
+    // every second entry is sampled
+    CHECK(testReader.read_next_entry().value() == 0);
+    const auto first = testReader.last_enqueue_timestamp();
+    REQUIRE(first.has_value());
+    CHECK(testReader.read_next_entry().value() == 1);
+    CHECK(!testReader.last_enqueue_timestamp().has_value());
+    CHECK(testReader.read_next_entry().value() == 2);
+    REQUIRE(testReader.last_enqueue_timestamp().has_value());
+    CHECK(testReader.last_enqueue_timestamp().value() >= first.value());
+    CHECK(SLQ_Auxil::read_tsc() >= testReader.last_enqueue_timestamp().value());
+    // the time stamp is stored outside the payload
+    CHECK(slqClass::padding_per_element == 12 + sizeof(std::uint64_t));
+    // timestamps disabled: nothing stored
+    using plainClass = Queue::SeqLockQueue<int, 8, true, false>;
+    plainClass plainSlq{};
+    auto plainReader = plainSlq.get_reader();
+    plainSlq.enqueue(1);
+    CHECK(plainReader.read_next_entry().value() == 1);
+    CHECK(!plainReader.last_enqueue_timestamp().has_value());
+  }
+
+SUBCASE("testing layout report") {
+    using sharedClass = Queue::SeqLockQueue<int, 8, true, false>;
+    CHECK(sharedClass::element_size == 16);
+    CHECK(sharedClass::alignment == 8);
+    CHECK(sharedClass::elements_per_cacheline == 4);
+    CHECK(sharedClass::cachelines_per_element == 1);
+    CHECK(!sharedClass::elements_straddle_cachelines);
+    CHECK(sharedClass::padding_per_element == 12);
+    CHECK(sharedClass::footprint == 128);
+    using separateClass = Queue::SeqLockQueue<int, 8, false, false>;
+    CHECK(separateClass::element_size == 64);
+    CHECK(separateClass::alignment == 64);
+    CHECK(separateClass::elements_per_cacheline == 1);
+    CHECK(separateClass::padding_per_element == 60);
+    CHECK(separateClass::footprint == 512);
+    using straddlingClass = Queue::SeqLockQueue<test_class_12bytes, 8, true, true>;
+    CHECK(straddlingClass::element_size == 24);
+    CHECK(straddlingClass::elements_per_cacheline == 2);
+    CHECK(straddlingClass::elements_straddle_cachelines);
+    CHECK(straddlingClass::cachelines_per_element == 2);
+    CHECK(straddlingClass::padding_fraction == doctest::Approx(0.5));
+    using largeClass = Queue::SeqLockQueue<std::array<char, 100>, 8, true, true>;
+    CHECK(largeClass::element_size == 112);
+    CHECK(largeClass::elements_per_cacheline == 0);
+    // 112 byte elements at offset 48 within a cacheline span three of them
+    CHECK(largeClass::cachelines_per_element == 3);
+    using doubleBufferedClass = Queue::SeqLockQueue<int, 8, false, true, true>;
+    CHECK(doubleBufferedClass::element_size == 64);
+    CHECK(doubleBufferedClass::padding_per_element == 60);
+  }
 }
 
 int main() {
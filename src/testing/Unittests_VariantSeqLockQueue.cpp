@@ -0,0 +1,122 @@
+#define DOCTEST_CONFIG_IMPLEMENT
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+#include "VariantQueue.hpp"
+
+struct Quote {
+  std::int64_t price;
+  std::int32_t size;
+};
+
+struct Trade {
+  std::int64_t price;
+  std::int64_t size;
+  std::array<char, 16> venue;
+};
+
+struct Heartbeat {
+  std::uint8_t sequence;
+};
+
+// collects the type index and a checksum of every message it visits
+struct RecordingVisitor {
+  std::vector<int> types;
+  std::int64_t sum = 0;
+  void operator()(const Quote& quote) {
+    types.push_back(0);
+    sum += quote.price + quote.size;
+  };
+  void operator()(const Trade& trade) {
+    types.push_back(1);
+    sum += trade.price + trade.size + trade.venue[0];
+  };
+  void operator()(const Heartbeat& heartbeat) {
+    types.push_back(2);
+    sum += heartbeat.sequence;
+  };
+};
+
+TEST_CASE("testing Queue::VariantSeqLockQueue") {
+  SUBCASE("testing type helpers") {
+    static_assert(Queue::type_index<Trade, Quote, Trade, Heartbeat>() == 1);
+    static_assert(Queue::type_index<int, Quote, Trade, Heartbeat>() == 3);
+    static_assert(Queue::distinct_types<Quote, Trade, Heartbeat>());
+    static_assert(!Queue::distinct_types<Quote, Trade, Quote>());
+    using slotClass = Queue::TaggedSlot<Quote, Trade, Heartbeat>;
+    CHECK(slotClass::storage_size == sizeof(Trade));
+    CHECK(sizeof(slotClass) == sizeof(Trade) + alignof(Trade));
+  }
+
+  SUBCASE("testing order across types") {
+    using slqClass = Queue::VariantSeqLockQueue<8, true, false, Quote, Trade, Heartbeat>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    RecordingVisitor visitor;
+    CHECK(!testReader.read_next_entry(visitor));
+    testSlq.enqueue(Trade{100, 5, {'X'}});
+    testSlq.enqueue(Quote{99, 7});
+    testSlq.enqueue(Heartbeat{3});
+    testSlq.enqueue(Quote{101, 2});
+    while (testReader.read_next_entry(visitor)) {
+    };
+    CHECK(visitor.types == std::vector<int>{1, 0, 2, 0});
+    CHECK(visitor.sum == 100 + 5 + 'X' + 99 + 7 + 3 + 101 + 2);
+  }
+
+  SUBCASE("testing generic visitor") {
+    using slqClass = Queue::VariantSeqLockQueue<8, false, true, Quote, Heartbeat>;
+    slqClass testSlq;
+    auto testReader = testSlq.get_reader();
+    testSlq.enqueue(Heartbeat{1});
+    std::size_t visitedSize = 0;
+    CHECK(testReader.read_next_entry([&visitedSize](const auto& message) { visitedSize = sizeof(message); }));
+    CHECK(visitedSize == sizeof(Heartbeat));
+  }
+
+  SUBCASE("testing concurrent enqueueing and dequeueing") {
+    using slqClass = Queue::VariantSeqLockQueue<1024, true, false, Quote, Trade, Heartbeat>;
+    slqClass testSlq;
+    constexpr int nMessages = 900;
+    std::atomic<bool> readerReady = false;
+    RecordingVisitor visitor;
+    std::jthread readerThread([&]() {
+      auto testReader = testSlq.get_reader();
+      readerReady.store(true);
+      while (visitor.types.size() < nMessages) {
+        testReader.read_next_entry(visitor);
+      };
+    });
+    while (!readerReady.load()) {
+    };
+    std::int64_t enqSum = 0;
+    for (int i = 0; i < nMessages; ++i) {
+      if (i % 3 == 0) {
+        testSlq.enqueue(Quote{i, 1});
+        enqSum += i + 1;
+      } else if (i % 3 == 1) {
+        testSlq.enqueue(Trade{i, 2, {'A'}});
+        enqSum += i + 2 + 'A';
+      } else {
+        testSlq.enqueue(Heartbeat{static_cast<std::uint8_t>(i)});
+        enqSum += static_cast<std::uint8_t>(i);
+      }
+    };
+    readerThread.join();
+    CHECK(visitor.sum == enqSum);
+    for (int i = 0; i < nMessages; ++i) {
+      CHECK(visitor.types[i] == i % 3);
+    };
+  }
+}
+
+int main() {
+  doctest::Context context;
+  context.run();
+}
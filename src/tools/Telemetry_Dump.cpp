@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "Telemetry.hpp"
+
+// prints the telemetry snapshots a process publishes via Telemetry::Publisher, maps the segment read-only and thus
+// never interferes with the queue it observes
+// usage: Telemetry_Dump name [--interval-ms n] [--count n]
+// --count 0 (the default) prints until interrupted
+
+void print_snapshot(const Telemetry::Snapshot& snapshot) {
+   const std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+   std::printf("\npublished %.3f s ago, capacity %u, producer position %lld, %.3e msgs/s, %llu written\n",
+      (now_ns - snapshot.published_ns) / 1e9, snapshot.queue_capacity, static_cast<long long>(snapshot.producer_position),
+      snapshot.producer_rate, static_cast<unsigned long long>(snapshot.producer_stats.messages_written));
+   std::printf("%-24s %12s %10s %12s %12s %10s %12s %10s\n", "reader", "position", "lag", "read", "empty polls", "retries", "spins",
+      "overruns");
+   for(std::uint32_t r = 0; r < snapshot.n_readers; ++r) {
+      const Registry::ReaderLag& reader = snapshot.readers[r];
+      // lapped readers have missed entries
+      std::printf("%-24.24s %12lld %10lld%s %12llu %12llu %10llu %12llu %10llu\n", reader.name.data(), static_cast<long long>(reader.position),
+         static_cast<long long>(reader.lag), reader.lag > snapshot.queue_capacity ? "!" : " ",
+         static_cast<unsigned long long>(reader.stats.messages_read), static_cast<unsigned long long>(reader.stats.empty_polls),
+         static_cast<unsigned long long>(reader.stats.retries), static_cast<unsigned long long>(reader.stats.spin_iterations),
+         static_cast<unsigned long long>(reader.stats.overruns));
+   }
+};
+
+int main(int argc, char** argv) {
+   if(argc < 2) {
+      std::fprintf(stderr, "usage: %s name [--interval-ms n] [--count n]\n", argv[0]);
+      return 1;
+   }
+   std::uint64_t interval_ms = 1000;
+   std::uint64_t count = 0;
+   for(int i = 2; i + 1 < argc; i += 2) {
+      const std::string_view option = argv[i];
+      if(option == "--interval-ms") {
+         interval_ms = std::strtoull(argv[i + 1], nullptr, 10);
+      }
+      else if(option == "--count") {
+         count = std::strtoull(argv[i + 1], nullptr, 10);
+      }
+   }
+   const Telemetry::Monitor monitor(argv[1]);
+   if(!monitor.is_open()) {
+      std::fprintf(stderr, "no compatible telemetry segment named %s\n", argv[1]);
+      return 1;
+   }
+   for(std::uint64_t n = 0; count == 0 || n < count; ++n) {
+      const auto snapshot = monitor.read();
+      if(!snapshot.has_value()) {
+         std::printf("stale: a snapshot has been in the middle of being published for too long, the publisher may have died\n");
+      }
+      else if(snapshot->published_ns == 0) {
+         std::printf("nothing published yet\n");
+      }
+      else {
+         print_snapshot(snapshot.value());
+      }
+      std::fflush(stdout);
+      if(count == 0 || n + 1 < count) {
+         std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+      }
+   }
+}